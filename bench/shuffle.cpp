@@ -41,6 +41,32 @@ namespace sqsgen::bench {
       ankerl::nanobench::doNotOptimizeAway(species);
     });
   }
+
+  void bench_shuffler(ankerl::nanobench::Bench* bench, usize_t num_sites) {
+    configuration_t species(num_sites);
+    for (usize_t i = 0; i < num_sites; ++i) species[i] = static_cast<specie_t>(i % 3);
+    uint64_t seed = 0xbdd89aa982704029ull;
+    core::shuffler shuffler({{0, num_sites}}, seed);
+
+    bench->run(std::format("serial ({})", num_sites), [&]() {
+      shuffle_configuration(species, seed);
+      ankerl::nanobench::doNotOptimizeAway(species);
+    });
+    bench->run(std::format("shuffler ({})", num_sites), [&]() {
+      shuffler.shuffle<ITERATION_MODE_RANDOM>(species);
+      ankerl::nanobench::doNotOptimizeAway(species);
+    });
+    // several configurations are shuffled per run, hence the batch size
+    for (usize_t num_interleaved : {2, 4}) {
+      std::vector<configuration_t> batch(num_interleaved, species);
+      bench->batch(num_interleaved)
+          .run(std::format("interleaved x{} ({})", num_interleaved, num_sites), [&]() {
+            shuffler.shuffle(batch);
+            ankerl::nanobench::doNotOptimizeAway(batch);
+          });
+    }
+    bench->batch(1);
+  }
 }  // namespace sqsgen::bench
 
 int main() {
@@ -66,4 +92,12 @@ int main() {
   });
 
   std::cout << format_vector<sqsgen::specie_t, int>(species) << std::endl;
+
+  ankerl::nanobench::Bench s;
+  s.title("Serial vs interleaved Fisher-Yates shuffle")
+      .warmup(100)
+      .minEpochIterations(1000)
+      .relative(true);
+  s.performanceCounters(true);
+  for (auto num_sites : {64, 512, 4096}) bench_shuffler(&s, num_sites);
 }
@@ -9,7 +9,10 @@
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/core/structure.h"
 #include "sqsgen/io/config/combined.h"
+#include "sqsgen/io/export.h"
+#include "sqsgen/io/merge.h"
 #include "sqsgen/io/mpi.h"
+#include "sqsgen/io/pack.h"
 #include "sqsgen/io/structure.h"
 #include "sqsgen/log.h"
 #include "sqsgen/sqs.h"
@@ -68,12 +71,17 @@ void display_version_info() {
   print_row("MPI", sqsgen::io::mpi::HAVE_MPI ? "yes" : "no");
 }
 
-using result_packt_t = std::variant<core::sqs_result_pack<float, SUBLATTICE_MODE_SPLIT>,
-                                    core::sqs_result_pack<double, SUBLATTICE_MODE_SPLIT>,
-                                    core::sqs_result_pack<float, SUBLATTICE_MODE_INTERACT>,
-                                    core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>>;
+using result_packt_t = io::sqs_result_pack_t;
 result_packt_t load_result_pack(std::string const& path, Prec prec = PREC_SINGLE) {
   using namespace sqsgen;
+  if (io::is_columnar_pack(path)) {
+    try {
+      return io::read_pack(path);
+    } catch (std::exception const& e) {
+      cli::render_error(format_string("'%s' is not a valid result pack", path), true, std::nullopt,
+                        e.what());
+    }
+  }
   auto pack_json = cli::read_msgpack(path);
   if (!pack_json.contains("config"))
     cli::render_error("Invalid result pack - cannot find config", true);
@@ -91,6 +99,20 @@ result_packt_t load_result_pack(std::string const& path, Prec prec = PREC_SINGLE
   throw std::invalid_argument("Invalid result pack - invalid sublattice_mode");
 }
 
+// columnar files are mapped into memory, results are only decoded once they are accessed
+io::pack_view_t open_result_pack(std::string const& path) {
+  using namespace sqsgen;
+  if (io::is_columnar_pack(path)) {
+    try {
+      return io::open_pack(path);
+    } catch (std::exception const& e) {
+      cli::render_error(format_string("'%s' is not a valid result pack", path), true, std::nullopt,
+                        e.what());
+    }
+  }
+  return io::make_view(load_result_pack(path));
+}
+
 template <class T, SublatticeMode Mode>
 void show_result_pack(core::sqs_result_pack<T, Mode> const& pack) {
   using namespace termcolor;
@@ -100,6 +122,8 @@ void show_result_pack(core::sqs_result_pack<T, Mode> const& pack) {
   std::cout << bold << "min(O(σ)): " << reset
             << format_string("%.5f", pack.statistics.best_objective) << std::endl;
   std::cout << bold << "Num. objectives: " << reset << pack.results.size() << std::endl;
+  if (!pack.variants.empty())
+    std::cout << bold << "Num. variants: " << reset << pack.variants.size() << std::endl;
   std::cout << std::endl;
 
   auto index = 0;
@@ -111,6 +135,26 @@ void show_result_pack(core::sqs_result_pack<T, Mode> const& pack) {
                                            }));
 }
 
+template <class T, SublatticeMode Mode> void show_result_pack(io::pack_view<T, Mode> const& view) {
+  using namespace termcolor;
+
+  std::cout << bold << "Mode: " << reset << italic
+            << (Mode == SUBLATTICE_MODE_INTERACT ? "interact" : "split") << reset << std::endl;
+  std::cout << bold << "min(O(σ)): " << reset
+            << format_string("%.5f", view.statistics().best_objective) << std::endl;
+  std::cout << bold << "Num. objectives: " << reset << view.size() << std::endl;
+  if (view.num_variants() > 0)
+    std::cout << bold << "Num. variants: " << reset << view.num_variants() << std::endl;
+  std::cout << std::endl;
+
+  cli::table<"INDEX", "OBJ.", "N">::render(
+      core::helpers::range(view.size()) | views::transform([&](auto index) {
+        return std::array{format_cyan(std::to_string(index)),
+                          format_string("%.5f", view.objective(index)),
+                          std::to_string(view.num_results(index))};
+      }));
+}
+
 void render_template_overview() {
   cli::table<"NAME", "AUTHOR(S)", "TAGS">::render(
       templates::detail::templates
@@ -175,8 +219,84 @@ void render_template(templates::config_template const& tpl) {
     cli::render_error(format_string("Cannot open output file \"%s.sqs.json\"", tpl.name), true);
   out << tpl.config.dump(2);
 }
+template <class T, SublatticeMode Mode>
+void dump_result_pack(std::string const& output, core::sqs_result_pack<T, Mode> const& pack) {
+  std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.good()) cli::render_error(format_string("Failed to open output file '%s'", output));
+  try {
+    io::write_pack(out, pack);
+  } catch (std::exception const& e) {
+    cli::render_error(format_string("Failed to write output file '%s'", output), true,
+                      std::nullopt, e.what());
+  }
+}
+
+template <class Optimize>
+void run_and_dump(std::optional<iterations_t> const& total, std::string const& output,
+                  sqsgen::log::level log_level, bool quiet, Optimize&& optimize) {
+  using namespace sqsgen;
+
+  auto progress = cli::Progress("Progress", total.value(), 50);
+
+  std::optional<sqs_callback_t> callback = std::nullopt;
+  if (!quiet)
+    callback = [total = total.value(), &progress](auto&& ctx) {
+      progress.set_progress(std::forward<decltype(ctx)>(ctx));
+      auto finished = std::visit([](auto&& c) { return c.statistics.finished; }, ctx);
+      progress.render(std::cout, finished >= total);
+    };
+  log::set_level(log_level);
+  auto result = optimize(log_level, callback);
+
+#ifdef WITH_MPI
+  bool should_dump{mpl::environment::comm_world().rank() == io::mpi::RANK_HEAD};
+#else
+  bool should_dump{true};
+#endif
+
+  if (should_dump) std::visit([&](auto&& r) { dump_result_pack(output, r); }, result);
+}
+
+// the pack of entry index of a sweep is written to <stem>.<index><extension> of output
+std::string sweep_output(std::string const& output, std::size_t index) {
+  auto path = std::filesystem::path(output);
+  auto extension = path.extension().string();
+  return path.replace_extension(format_string("%i%s", index, extension)).string();
+}
+
+template <class T>
+void run_sweep_and_dump(std::vector<sqsgen::core::configuration<T>>&& configs,
+                        std::string const& output, sqsgen::log::level log_level, bool quiet) {
+  using namespace sqsgen;
+  auto totals = core::helpers::as<std::vector>{}(
+      configs | views::transform([](auto&& config) { return config.iterations.value(); }));
+  // every composition gets a progress bar of its own
+  auto progress = std::make_unique<cli::Progress>("Progress", totals.front(), 50);
+  std::size_t current{0};
+
+  std::optional<sqs_callback_t> callback = std::nullopt;
+  if (!quiet)
+    callback = [&](auto&& ctx) {
+      progress->set_progress(std::forward<decltype(ctx)>(ctx));
+      auto finished = std::visit([](auto&& c) { return c.statistics.finished; }, ctx);
+      progress->render(std::cout, finished >= totals[current]);
+    };
+#ifdef WITH_MPI
+  bool should_dump{mpl::environment::comm_world().rank() == io::mpi::RANK_HEAD};
+#else
+  bool should_dump{true};
+#endif
+  log::set_level(log_level);
+  run_sweep(std::move(configs), log_level, callback, [&](auto index, auto&& result) {
+    if (should_dump)
+      std::visit([&](auto&& r) { dump_result_pack(sweep_output(output, index), r); }, result);
+    if (++current < totals.size())
+      progress = std::make_unique<cli::Progress>("Progress", totals[current], 50);
+  });
+}
+
 void run_main(std::string const& input, std::string const& output, std::string const& log_level,
-              bool quiet) {
+              bool quiet, std::optional<std::string> const& resume) {
   using namespace sqsgen;
   using namespace sqsgen::core;
   using namespace sqsgen::core::helpers;
@@ -190,42 +310,53 @@ void run_main(std::string const& input, std::string const& output, std::string c
   if (!log_levels.contains(log_level))
     cli::render_error(format_string("Invalid log level '%s'", log_level));
 
+  if (resume.has_value()) {
+    auto path = resume.value();
+#ifdef WITH_MPI
+    path = io::checkpoint_path(path, mpl::environment::comm_world().rank(),
+                               mpl::environment::comm_world().size())
+               .string();
+#endif
+    if (!std::filesystem::exists(path))
+      cli::render_error(format_string("Checkpoint '%s' does not exist", path));
+    std::optional<sqs_checkpoint_t> checkpoint;
+    try {
+      checkpoint = io::read_checkpoint(path);
+    } catch (std::exception const& e) {
+      cli::render_error(format_string("Failed to read checkpoint '%s'", path), true, std::nullopt,
+                        e.what());
+    }
+    auto total = std::visit([](auto&& c) { return c.config.iterations; }, checkpoint.value());
+    run_and_dump(total, output, log_levels[log_level], quiet, [&](auto level, auto callback) {
+      return resume_optimization(std::move(checkpoint.value()), level, callback);
+    });
+    return;
+  }
+
   if (!std::filesystem::exists(input))
     cli::render_error(format_string("File '%s' does not exist", input));
 
-  auto conf = io::config::parse_config(cli::read_json(input));
+  auto document = cli::read_json(input);
+  if (document.contains("sweep")) {
+    auto sweep = io::config::parse_sweep(document);
+    if (sweep.failed()) {
+      auto err = sweep.error();
+      cli::render_error(err.msg, true, err.key);
+    }
+    std::visit(
+        [&](auto&& configs) {
+          run_sweep_and_dump(std::move(configs), output, log_levels[log_level], quiet);
+        },
+        sweep.result());
+    return;
+  }
+
+  auto conf = io::config::parse_config(document);
   if (conf.ok()) {
     auto total = std::visit([](auto&& config) { return config.iterations; }, conf.result());
-
-    auto progress = cli::Progress("Progress", total.value(), 50);
-
-    std::optional<sqs_callback_t> callback = std::nullopt;
-    if (!quiet)
-      callback = [total = total.value(), &progress](auto&& ctx) {
-        progress.set_progress(std::forward<decltype(ctx)>(ctx));
-        auto finished = std::visit([](auto&& c) { return c.statistics.finished; }, ctx);
-        progress.render(std::cout, finished >= total);
-      };
-    log::set_level(log_levels[log_level]);
-    auto result = run_optimization(conf.result(), log_levels[log_level], callback);
-
-#ifdef WITH_MPI
-    bool should_dump{mpl::environment::comm_world().rank() == io::mpi::RANK_HEAD};
-#else
-    bool should_dump{true};
-#endif
-
-    if (should_dump) {
-      std::vector<uint8_t> dump;
-      std::visit(
-          [&dump](auto&& r) {
-            nlohmann::json j = r;
-            dump = nlohmann::json::to_msgpack(j);
-          },
-          result);
-      std::ofstream out(output, std::ios::out | std::ios::binary);
-      out.write(reinterpret_cast<const std::ostream::char_type*>(dump.data()), dump.size());
-    }
+    run_and_dump(total, output, log_levels[log_level], quiet, [&](auto level, auto callback) {
+      return run_optimization(conf.result(), level, callback);
+    });
   } else {
     auto err = conf.error();
     cli::render_error(err.msg, true, err.key);
@@ -264,6 +395,10 @@ int main(int argc, char** argv) {
       .default_value("sqs.mpack")
       .nargs(1);
 
+  program.add_argument("-r", "--resume")
+      .help("Continue an interrupted optimization from a checkpoint file")
+      .nargs(1);
+
   program.add_argument("-l", "--log")
       .help("set the log value")
       .default_value(std::string{"warn"})
@@ -292,6 +427,10 @@ int main(int argc, char** argv) {
       .default_value("sqs.mpack")
       .nargs(1);
 
+  output_command.add_argument("--variant")
+      .help("display the results of the n-th objective variant instead of the main objective")
+      .nargs(1);
+
   argparse::ArgumentParser output_config_command("config");
   output_config_command.add_argument("-v", "--version")
       .help("Display version info")
@@ -304,9 +443,9 @@ int main(int argc, char** argv) {
   output_structure_command.add_description("export the structure of a result file");
 
   output_structure_command.add_argument("-f", "--format")
-      .help("The output format to use (vasp, poscar, ase, pymatgen, cif, sqsgen, pdb)")
+      .help("The output format to use (vasp, poscar, ase, pymatgen, cif, sqsgen, pdb, xyz)")
       .default_value(std::string{"sqsgen"})
-      .choices("pymatgen", "ase", "vasp", "poscar", "sqsgen", "cif", "pdb")
+      .choices("pymatgen", "ase", "vasp", "poscar", "sqsgen", "cif", "pdb", "xyz")
       .nargs(1);
 
   output_structure_command.add_argument("-p", "--print")
@@ -330,10 +469,51 @@ int main(int argc, char** argv) {
   output_structure_command.add_argument("--all").default_value(false).implicit_value(true).help(
       "Export all structures of a certain objective value, specified by the --objective option");
 
+  output_structure_command.add_argument("--frames").default_value(false).implicit_value(true).help(
+      "write all exported structures into a single multi-frame file, e.g. sqs.xyz. JSON formats "
+      "are written with one document per line");
+  output_structure_command.add_argument("--tar").default_value(false).implicit_value(true).help(
+      "write all exported structures into a single uncompressed tar archive, e.g. sqs.cif.tar");
+
   output_command.add_subparser(output_config_command);
   output_command.add_subparser(output_structure_command);
 
   program.add_subparser(output_command);
+
+  argparse::ArgumentParser rescore_command("rescore", version_string,
+                                           argparse::default_arguments::help);
+  rescore_command.add_description(
+      "rank the results of a SQS optimization run under new parameters of the objective function");
+  rescore_command.add_argument("params").help(
+      "JSON file with the new \"shell_weights\", \"pair_weights\", \"prefactors\" or "
+      "\"target_objective\"");
+  rescore_command.add_argument("-o", "--output")
+      .help("The output file whose results should be rescored")
+      .default_value("sqs.mpack")
+      .nargs(1);
+  rescore_command.add_argument("-w", "--write")
+      .help("The file to write the rescored results to. Defaults to <output>.rescored.mpack")
+      .nargs(1);
+
+  program.add_subparser(rescore_command);
+
+  argparse::ArgumentParser merge_command("merge", version_string,
+                                         argparse::default_arguments::help);
+  merge_command.add_description(
+      "combine the result files of independent runs, e.g. with different seeds, into a single "
+      "result file");
+  merge_command.add_argument("shards")
+      .help("The result files to merge, they must share the structure and objective function")
+      .nargs(argparse::nargs_pattern::at_least_one);
+  merge_command.add_argument("-w", "--write")
+      .help("The file to write the merged results to")
+      .default_value(std::string{"sqs.merged.mpack"})
+      .nargs(1);
+  merge_command.add_argument("-k", "--keep")
+      .help("The number of objectives to keep. Defaults to \"keep\" of the first result file")
+      .nargs(1);
+
+  program.add_subparser(merge_command);
   // "A simple tool to create special-quasirandom-structures (SQS)"
 
   try {
@@ -374,16 +554,26 @@ int main(int argc, char** argv) {
     auto output_file = !output_command.is_used(output_switch) && program.is_used(output_switch)
                            ? program.get<std::string>(output_switch)
                            : output_command.get<std::string>(output_switch);
-    auto pack = load_result_pack(output_file);
+    auto pack = open_result_pack(output_file);
+    if (output_command.is_used("--variant")) {
+      auto raw = output_command.get<std::string>("--variant");
+      pack = std::visit(
+          [&](auto&& p) -> io::pack_view_t {
+            if (p.num_variants() == 0)
+              cli::render_error("The result file does not contain any objective variants", true);
+            return p.variant(cli::validate_index(raw, p.num_variants()));
+          },
+          pack);
+    }
     if (output_command.is_subcommand_used("config")) {
       std::string output
           = format_string("%s.config.json", std::filesystem::path(output_file).stem().string());
       std::ofstream out(output, std::ios::out);
       if (!out.good()) cli::render_error(format_string("Failed to open output file '%s'", output));
-      out << std::visit([](auto&& p) { return cli::fixup_config_json(p.config).dump(); }, pack);
+      out << std::visit([](auto&& p) { return cli::fixup_config_json(p.config()).dump(); }, pack);
       return EXIT_SUCCESS;
     } else if (output_command.is_subcommand_used("structure")) {
-      auto num_objectives = std::visit([](auto&& p) { return p.results.size(); }, pack);
+      auto num_objectives = std::visit([](auto&& p) { return p.size(); }, pack);
       auto objective_indices = helpers::as<std::set>{}(
           output_structure_command.get<std::vector<std::string>>("--objective")
           | views::transform(
@@ -392,8 +582,8 @@ int main(int argc, char** argv) {
       auto structure_indices = std::vector<std::pair<int, int>>{};
 
       ranges::for_each(objective_indices, [&, export_all](auto&& index) {
-        int num_structures = std::visit(
-            [index](auto& p) { return std::get<1>(p.results.at(index)).size(); }, pack);
+        int num_structures
+            = std::visit([index](auto& p) { return p.num_results(index); }, pack);
         const auto append = [&, index](int i) { structure_indices.push_back({index, i}); };
         if (export_all)
           ranges::for_each(range<int>(num_structures), append);
@@ -402,46 +592,71 @@ int main(int argc, char** argv) {
                            [&](auto&& raw) { append(cli::validate_index(raw, num_structures)); });
       });
 
-      ranges::for_each(structure_indices, [&](auto&& indices) {
-        auto [objective_index, structure_index] = indices;
-        std::visit(
-            [&, objective_index,
-             structure_index]<class T, SublatticeMode Mode>(sqs_result_pack<T, Mode> const& p) {
-              auto structure
-                  = std::get<1>(p.results.at(objective_index)).at(structure_index).structure();
-              auto format = output_structure_command.get<std::string>("--format");
-              auto basename = std::filesystem::path(output_file).stem().string();
-
-              std::map<std::string, std::pair<StructureFormat, std::string>> formats{
-                  {"vasp", {STRUCTURE_FORMAT_POSCAR, "vasp"}},
-                  {"poscar", {STRUCTURE_FORMAT_POSCAR, "vasp"}},
-                  {"pymatgen", {STRUCTURE_FORMAT_JSON_PYMATGEN, "pymatgen.json"}},
-                  {"sqsgen", {STRUCTURE_FORMAT_JSON_SQSGEN, "sqsgen.json"}},
-                  {"pdb", {STRUCTURE_FORMAT_PDB, "pdb"}},
-                  {"cif", {STRUCTURE_FORMAT_CIF, "cif"}},
-                  {"ase", {STRUCTURE_FORMAT_JSON_ASE, "ase.json"}}};
-
-              auto result = formats.find(format);
-              if (result != formats.end()) {
-                auto [format, ext] = result->second;
-                auto text = io::format(structure, format);
-                std::string filename
-                    = format_string("%s-%i-%i.%s", basename, objective_index, structure_index, ext);
-                if (output_structure_command["--print"] == true) {
-                  if (structure_indices.size() > 1) std::cout << format_string("# %s", filename);
-                  std::cout << text << std::endl;
-                  if (structure_indices.size() > 1) std::cout << std::endl;
-                } else {
-                  std::ofstream out(filename, std::ios::out);
-                  if (!out.good())
-                    cli::render_error(format_string("Failed to open output file '%s'", filename));
-                  out << text;
-                }
-              } else
-                cli::render_error(format_string("Invalid format '%s'", format), true);
-            },
-            pack);
-      });
+      std::map<std::string, std::pair<StructureFormat, std::string>> formats{
+          {"vasp", {STRUCTURE_FORMAT_POSCAR, "vasp"}},
+          {"poscar", {STRUCTURE_FORMAT_POSCAR, "vasp"}},
+          {"pymatgen", {STRUCTURE_FORMAT_JSON_PYMATGEN, "pymatgen.json"}},
+          {"sqsgen", {STRUCTURE_FORMAT_JSON_SQSGEN, "sqsgen.json"}},
+          {"pdb", {STRUCTURE_FORMAT_PDB, "pdb"}},
+          {"cif", {STRUCTURE_FORMAT_CIF, "cif"}},
+          {"ase", {STRUCTURE_FORMAT_JSON_ASE, "ase.json"}},
+          {"xyz", {STRUCTURE_FORMAT_XYZ, "xyz"}}};
+      if (output_structure_command["--frames"] == true && output_structure_command["--tar"] == true)
+        cli::render_error("--frames and --tar cannot be used together", true);
+      auto format_name = output_structure_command.get<std::string>("--format");
+      auto selected = formats.find(format_name);
+      if (selected == formats.end())
+        cli::render_error(format_string("Invalid format '%s'", format_name), true);
+      auto [format, ext] = selected->second;
+      auto basename = std::filesystem::path(output_file).stem().string();
+
+      // the structures are decoded and formatted in parallel, the files are written afterward
+      auto texts = std::visit(
+          [&](auto const& p) {
+            return io::format_structures(
+                structure_indices.size(),
+                [&](std::size_t i) {
+                  auto [objective_index, structure_index] = structure_indices[i];
+                  return p.result(objective_index, structure_index).structure();
+                },
+                format);
+          },
+          pack);
+      auto filenames = helpers::as<std::vector>{}(
+          structure_indices | views::transform([&](auto&& indices) {
+            auto [objective_index, structure_index] = indices;
+            return format_string("%s-%i-%i.%s", basename, objective_index, structure_index, ext);
+          }));
+
+      const auto open_output = [](std::string const& filename) {
+        std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.good())
+          cli::render_error(format_string("Failed to open output file '%s'", filename));
+        return out;
+      };
+
+      try {
+        if (output_structure_command["--frames"] == true) {
+          auto json = format == STRUCTURE_FORMAT_JSON_SQSGEN
+                      || format == STRUCTURE_FORMAT_JSON_PYMATGEN
+                      || format == STRUCTURE_FORMAT_JSON_ASE;
+          auto out = open_output(format_string("%s.%s", basename, ext));
+          io::write_frames(out, texts, json ? "\n" : "");
+        } else if (output_structure_command["--tar"] == true) {
+          auto out = open_output(format_string("%s.%s.tar", basename, ext));
+          io::write_tar(out, filenames, texts);
+        } else if (output_structure_command["--print"] == true) {
+          for (std::size_t i = 0; i < texts.size(); ++i) {
+            if (texts.size() > 1) std::cout << format_string("# %s", filenames[i]);
+            std::cout << texts[i] << std::endl;
+            if (texts.size() > 1) std::cout << std::endl;
+          }
+        } else {
+          for (std::size_t i = 0; i < texts.size(); ++i) open_output(filenames[i]) << texts[i];
+        }
+      } catch (std::exception const& e) {
+        cli::render_error("Failed to export the structures", true, std::nullopt, e.what());
+      }
 
       return EXIT_SUCCESS;
     } else {
@@ -450,6 +665,64 @@ int main(int argc, char** argv) {
     }
   }
 
+  if (program.is_subcommand_used("rescore")) {
+    auto output_switch = "--output";
+    auto output_file = !rescore_command.is_used(output_switch) && program.is_used(output_switch)
+                           ? program.get<std::string>(output_switch)
+                           : rescore_command.get<std::string>(output_switch);
+    auto rescored_file = rescore_command.present<std::string>("--write").value_or(format_string(
+        "%s.rescored.mpack", std::filesystem::path(output_file).stem().string()));
+    auto params = cli::read_json(rescore_command.get<std::string>("params"));
+    auto pack = load_result_pack(output_file);
+    std::visit(
+        [&]<class T, SublatticeMode Mode>(sqs_result_pack<T, Mode> const& p) {
+          auto conf = io::config::parse_rescore_config<T>(params, p.config);
+          if (conf.failed()) {
+            auto err = conf.error();
+            cli::render_error(err.msg, true, err.key);
+          }
+          auto rescored = sqsgen::rescore(p, conf.result());
+          dump_result_pack(rescored_file, rescored);
+          if (program["--quiet"] == false) show_result_pack(rescored);
+        },
+        pack);
+    return EXIT_SUCCESS;
+  }
+
+  if (program.is_subcommand_used("merge")) {
+    auto shards = merge_command.get<std::vector<std::string>>("shards");
+    auto merged_file = merge_command.get<std::string>("--write");
+    std::optional<std::size_t> keep;
+    if (auto raw = merge_command.present<std::string>("--keep"); raw.has_value()) {
+      int k{0};
+      try {
+        k = std::stoi(raw.value());
+      } catch (std::exception const& e) {
+        cli::render_error(format_string("Invalid value for --keep: '%s'", raw.value()), true,
+                          std::nullopt, e.what());
+      }
+      if (k < 1)
+        cli::render_error(format_string("Invalid value for --keep: '%s'", raw.value()), true,
+                          std::nullopt, "at least one objective must be kept");
+      keep = static_cast<std::size_t>(k);
+    }
+    // the shards are opened one after another, only the best results are kept in memory
+    result_packt_t merged;
+    try {
+      merged = io::merge_packs(
+          shards.size(), [&](std::size_t i) { return open_result_pack(shards[i]); }, keep);
+    } catch (std::exception const& e) {
+      cli::render_error("Cannot merge the result files", true, std::nullopt, e.what());
+    }
+    std::visit(
+        [&](auto&& p) {
+          dump_result_pack(merged_file, p);
+          if (program["--quiet"] == false) show_result_pack(p);
+        },
+        merged);
+    return EXIT_SUCCESS;
+  }
+
   std::string output = program.get<std::string>("--output");
   if (program.is_used("--input") && !program.is_used("--output")) {
     // The user has specified a custom input file we try to split the extension
@@ -458,7 +731,7 @@ int main(int argc, char** argv) {
   }
 
   run_main(program.get<std::string>("--input"), output, program.get<std::string>("--log"),
-           program["--quiet"] == true);
+           program["--quiet"] == true, program.present<std::string>("--resume"));
 
   return 0;
 }
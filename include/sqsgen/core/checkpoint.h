@@ -0,0 +1,38 @@
+//
+// Created by Dominik Gehringer on 21.04.25.
+//
+
+#ifndef SQSGEN_CORE_CHECKPOINT_H
+#define SQSGEN_CORE_CHECKPOINT_H
+
+#include <variant>
+
+#include "sqsgen/core/config.h"
+#include "sqsgen/types.h"
+
+namespace sqsgen::core {
+
+  /*
+   * Snapshot of a (running) optimization. The results are stored exactly as they are kept in the
+   * result collection of the optimizer (i.e. in sorted order with packed species), such that they
+   * can be re-inserted without any post-processing. finished contains all chunks [start, end)
+   * which were evaluated completely, rng_state the state of the shuffler of each sublattice.
+   * variant_results holds the results of each variant of the objective function
+   */
+  template <class T, SublatticeMode Mode> struct sqs_checkpoint {
+    configuration<T> config;
+    sqs_statistics_data<T> statistics;
+    std::vector<sqs_result<T, Mode>> results;
+    std::vector<bounds_t<iterations_t>> finished;
+    std::vector<std::uint64_t> rng_state;
+    std::vector<std::vector<sqs_result<T, Mode>>> variant_results{};
+  };
+
+  using sqs_checkpoint_t = std::variant<sqs_checkpoint<float, SUBLATTICE_MODE_INTERACT>,
+                                        sqs_checkpoint<float, SUBLATTICE_MODE_SPLIT>,
+                                        sqs_checkpoint<double, SUBLATTICE_MODE_INTERACT>,
+                                        sqs_checkpoint<double, SUBLATTICE_MODE_SPLIT>>;
+
+}  // namespace sqsgen::core
+
+#endif  // SQSGEN_CORE_CHECKPOINT_H
@@ -6,8 +6,11 @@
 #define SQSGEN_CONFIGURATION_H
 
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <string>
 
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/structure.h"
 
 namespace sqsgen::core {
@@ -29,6 +32,14 @@ namespace sqsgen::core {
     }
   };
 
+  // a further set of parameters of the objective function, evaluated on the same bonds
+  template <class T> struct objective_variant {
+    std::vector<shell_weights_t<T>> shell_weights;
+    std::vector<cube_t<T>> prefactors;
+    std::vector<cube_t<T>> pair_weights;
+    std::vector<cube_t<T>> target_objective;
+  };
+
   template <class T> struct configuration {
     SublatticeMode sublattice_mode;
     IterationMode iteration_mode;
@@ -45,6 +56,38 @@ namespace sqsgen::core {
     thread_config_t thread_config;
     std::size_t keep;
     std::optional<std::size_t> max_results_per_objective;
+    bool shared_memory{false};
+    std::optional<std::string> checkpoint;
+    std::size_t checkpoint_interval{600};
+    // stopping rules, the run ends as soon as one of them applies
+    std::optional<std::size_t> max_time;
+    std::optional<T> objective_threshold;
+    std::optional<iterations_t> max_stagnation;
+    // store only the objective and the iteration index of a result
+    bool compact_results{false};
+    // results which are images of each other under this group are stored only once
+    DeduplicationMode deduplication{DEDUPLICATION_MODE_EXACT};
+    // every variant keeps its own best results
+    std::vector<objective_variant<T>> variants{};
+    // the neighbor analysis done while parsing, it is neither serialized nor part of the results
+    std::shared_ptr<core::geometry_cache<T>> geometry{};
+    // directory in which the neighbor analysis is kept across runs
+    std::optional<std::string> geometry_cache{};
+    // file to which the results are written while the run is going on
+    std::optional<std::string> spill{};
+    // number of results held in memory, if spill is set
+    std::size_t spill_limit{100000};
+
+    // the same run, but with the objective function of variant
+    configuration with_objective(objective_variant<T> const& variant) const {
+      configuration config{*this};
+      config.shell_weights = variant.shell_weights;
+      config.prefactors = variant.prefactors;
+      config.pair_weights = variant.pair_weights;
+      config.target_objective = variant.target_objective;
+      config.variants.clear();
+      return config;
+    }
   };
 
 }  // namespace sqsgen::core
@@ -0,0 +1,393 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_CORE_GEOMETRY_H
+#define SQSGEN_CORE_GEOMETRY_H
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+#include "sqsgen/core/helpers/mapped_file.h"
+#include "sqsgen/core/helpers/rapidhash.h"
+#include "sqsgen/core/structure.h"
+#include "sqsgen/types.h"
+
+namespace sqsgen::core {
+
+  namespace detail {
+
+    // entries of a geometry cache directory are flat arrays of trivially copyable values
+    class geometry_writer {
+      std::vector<std::byte> _bytes;
+
+    public:
+      template <class V>
+        requires std::is_trivially_copyable_v<V>
+      void put(V const& value) {
+        auto offset = _bytes.size();
+        _bytes.resize(offset + sizeof(V));
+        std::memcpy(_bytes.data() + offset, &value, sizeof(V));
+      }
+
+      template <class R> void put_range(R const& values) {
+        put(static_cast<std::uint64_t>(std::ranges::size(values)));
+        for (auto const& value : values) put(value);
+      }
+
+      [[nodiscard]] std::vector<std::byte> const& bytes() const { return _bytes; }
+    };
+
+    class geometry_reader {
+      std::span<const std::byte> _bytes;
+
+    public:
+      explicit geometry_reader(std::span<const std::byte> bytes) : _bytes(bytes) {}
+
+      template <class V>
+        requires std::is_trivially_copyable_v<V>
+      V get() {
+        if (_bytes.size() < sizeof(V)) throw std::out_of_range("Truncated geometry cache entry");
+        V value;
+        std::memcpy(&value, _bytes.data(), sizeof(V));
+        _bytes = _bytes.subspan(sizeof(V));
+        return value;
+      }
+
+      template <class V> std::vector<V> get_vector() {
+        auto size = get<std::uint64_t>();
+        if (_bytes.size() / sizeof(V) < size)
+          throw std::out_of_range("Truncated geometry cache entry");
+        std::vector<V> values(size);
+        std::memcpy(values.data(), _bytes.data(), size * sizeof(V));
+        _bytes = _bytes.subspan(size * sizeof(V));
+        return values;
+      }
+
+      [[nodiscard]] std::size_t remaining() const { return _bytes.size(); }
+
+      [[nodiscard]] bool empty() const { return _bytes.empty(); }
+    };
+
+    struct geometry_header {
+      // "SQSGGEOM" on little-endian machines, hence files of the other byte order are rejected
+      static constexpr std::uint64_t MAGIC = 0x4d4f454747535153;
+      static constexpr std::uint32_t VERSION = 1;
+
+      std::uint64_t magic{MAGIC};
+      std::uint32_t version{VERSION};
+      std::uint16_t value_size;
+      std::uint16_t size_size;
+      std::uint64_t kind;
+      std::uint64_t key_size;
+      std::uint64_t payload_size;
+    };
+
+  }  // namespace detail
+
+  /*
+   * The neighbor analysis of structures which share their geometry. A configuration carries the
+   * context from parsing into the setup of the optimization, and all compositions of a sweep share
+   * one. Shell radii, neighbor counts and pair lists do not depend on the species, hence an entry
+   * is identified by the sites, the shell radii and the weighted shells only.
+   *
+   * If a directory is given, entries which are not in memory are looked up on disk before they are
+   * computed, and computed ones are written there. A file is named by the hash of its key, and is
+   * only used if the key stored in it matches exactly. Thus, a stale or foreign file is recomputed
+   * and replaced
+   */
+  template <class T> class geometry_cache {
+    using pairs_t = decltype(std::declval<structure<T>&>().pairs(
+        std::declval<std::vector<T> const&>(), std::declval<shell_weights_t<T> const&>()));
+    using periodic_pairs_t = std::optional<periodic_pair_list<usize_t>>;
+
+    struct key {
+      lattice_t<T> lattice;
+      coords_t<T> frac_coords;
+      std::array<bool, 3> pbc;
+      std::array<std::size_t, 3> supercell_shape;
+      std::vector<T> radii;
+      std::vector<usize_t> shells;
+
+      key(structure<T> const& s, std::vector<T> const& radii, std::vector<usize_t> shells)
+          : lattice(s.lattice),
+            frac_coords(s.frac_coords),
+            pbc(s.pbc),
+            supercell_shape(s.supercell_shape),
+            radii(radii),
+            shells(std::move(shells)) {}
+
+      key(structure<T> const& s, std::vector<T> const& radii, shell_weights_t<T> const& weights)
+          : key(s, radii, helpers::as<std::vector>{}(weights | views::elements<0>)) {}
+
+      bool operator==(key const& other) const {
+        return pbc == other.pbc && supercell_shape == other.supercell_shape
+               && radii == other.radii && shells == other.shells
+               && frac_coords.rows() == other.frac_coords.rows() && lattice == other.lattice
+               && frac_coords == other.frac_coords;
+      }
+
+      [[nodiscard]] std::vector<std::byte> bytes() const {
+        detail::geometry_writer writer;
+        for (auto i = 0; i < 3; ++i)
+          for (auto j = 0; j < 3; ++j) writer.put(lattice(i, j));
+        for (auto p : pbc) writer.put(static_cast<std::uint8_t>(p));
+        for (auto n : supercell_shape) writer.put(static_cast<std::uint64_t>(n));
+        writer.put(static_cast<std::uint64_t>(frac_coords.rows()));
+        for (auto i = 0; i < frac_coords.rows(); ++i)
+          for (auto j = 0; j < 3; ++j) writer.put(frac_coords(i, j));
+        writer.put_range(radii);
+        writer.put_range(shells);
+        return writer.bytes();
+      }
+    };
+
+    enum entry_kind : std::uint64_t { SHELL_RADII = 0, PAIRS = 1, PERIODIC_PAIRS = 2 };
+
+    std::mutex _mutex;
+    std::optional<std::filesystem::path> _directory;
+    std::vector<std::pair<key, std::vector<T>>> _shell_radii;
+    std::vector<std::pair<key, pairs_t>> _pairs;
+    std::vector<std::pair<key, periodic_pairs_t>> _periodic_pairs;
+
+    static void write_payload(detail::geometry_writer& writer, std::vector<T> const& radii) {
+      writer.put_range(radii);
+    }
+
+    static void write_payload(detail::geometry_writer& writer, pairs_t const& pairs) {
+      writer.put_range(std::get<0>(pairs));
+    }
+
+    static void write_payload(detail::geometry_writer& writer, periodic_pairs_t const& pairs) {
+      writer.put(static_cast<std::uint8_t>(pairs.has_value()));
+      if (!pairs.has_value()) return;
+      for (auto n : pairs.value().shape) writer.put(n);
+      writer.put(pairs.value().num_basis);
+      writer.put_range(pairs.value().bounds);
+      // a template is written field by field, its padding bytes are undefined
+      writer.put(static_cast<std::uint64_t>(pairs.value().templates.size()));
+      for (auto const& t : pairs.value().templates) {
+        for (auto n : t.offset) writer.put(n);
+        writer.put(t.basis);
+        writer.put(t.shell);
+        writer.put(static_cast<std::uint8_t>(t.symmetric));
+      }
+    }
+
+    static std::vector<T> read_payload(detail::geometry_reader& reader, key const&,
+                                       std::type_identity<std::vector<T>>) {
+      return reader.get_vector<T>();
+    }
+
+    static pairs_t read_payload(detail::geometry_reader& reader, key const& k,
+                                std::type_identity<pairs_t>) {
+      auto pairs = reader.get_vector<atom_pair<usize_t>>();
+      auto [shell_map, reverse_map] = helpers::make_index_mapping<usize_t>(k.shells);
+      return {std::move(pairs), std::move(shell_map), std::move(reverse_map)};
+    }
+
+    static periodic_pairs_t read_payload(detail::geometry_reader& reader, key const&,
+                                         std::type_identity<periodic_pairs_t>) {
+      if (reader.get<std::uint8_t>() == 0) return std::nullopt;
+      periodic_pair_list<usize_t> pairs;
+      for (auto& n : pairs.shape) n = reader.get<usize_t>();
+      pairs.num_basis = reader.get<usize_t>();
+      pairs.bounds = reader.get_vector<usize_t>();
+      auto num_templates = reader.get<std::uint64_t>();
+      if (reader.remaining() / (5 * sizeof(usize_t) + 1) < num_templates)
+        throw std::out_of_range("Truncated geometry cache entry");
+      pairs.templates.resize(num_templates);
+      for (auto& t : pairs.templates) {
+        for (auto& n : t.offset) n = reader.get<usize_t>();
+        t.basis = reader.get<usize_t>();
+        t.shell = reader.get<usize_t>();
+        t.symmetric = reader.get<std::uint8_t>() != 0;
+      }
+      if (pairs.bounds.size() != pairs.num_basis + 1 || pairs.bounds.back() != pairs.templates.size())
+        throw std::out_of_range("Inconsistent periodic pair list");
+      return pairs;
+    }
+
+    std::filesystem::path entry_path(std::vector<std::byte> const& key_bytes,
+                                     entry_kind kind) const {
+      static constexpr std::array<const char*, 3> names{"radii", "pairs", "periodic"};
+      auto hash = rapidhash_withSeed(key_bytes.data(), key_bytes.size(), kind);
+      return _directory.value() / format_string("%016x.%s", hash, names[kind]);
+    }
+
+    template <class V> std::optional<V> load(std::filesystem::path const& path,
+                                             std::vector<std::byte> const& key_bytes,
+                                             key const& k, entry_kind kind) const {
+      if (std::error_code ec; !std::filesystem::exists(path, ec)) return std::nullopt;
+      try {
+        helpers::mapped_file file(path);
+        auto bytes = file.bytes();
+        detail::geometry_header header;
+        if (bytes.size() < sizeof(header)) throw std::out_of_range("Truncated header");
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        bytes = bytes.subspan(sizeof(header));
+        if (header.magic != detail::geometry_header::MAGIC
+            || header.version != detail::geometry_header::VERSION
+            || header.value_size != sizeof(T) || header.size_size != sizeof(usize_t)
+            || header.kind != kind || header.key_size != key_bytes.size()
+            || bytes.size() != header.key_size + header.payload_size)
+          throw std::out_of_range("Incompatible header");
+        // a hash collision or a file of another structure
+        if (std::memcmp(bytes.data(), key_bytes.data(), key_bytes.size()) != 0)
+          return std::nullopt;
+        detail::geometry_reader reader(bytes.subspan(header.key_size));
+        auto value = read_payload(reader, k, std::type_identity<V>{});
+        if (!reader.empty()) throw std::out_of_range("Trailing data");
+        log::debug(format_string("Loaded cached geometry from \"%s\"", path.string()));
+        return value;
+      } catch (std::exception const& e) {
+        log::warn(format_string("Ignoring invalid geometry cache file \"%s\" (%s)", path.string(),
+                                e.what()));
+        return std::nullopt;
+      }
+    }
+
+    // the file is written to a temporary first, concurrent writers thus never see partial files
+    template <class V> void store(std::filesystem::path const& path,
+                                  std::vector<std::byte> const& key_bytes, entry_kind kind,
+                                  V const& value) const {
+      detail::geometry_writer payload;
+      write_payload(payload, value);
+      detail::geometry_header header{detail::geometry_header::MAGIC,
+                                     detail::geometry_header::VERSION,
+                                     sizeof(T),
+                                     sizeof(usize_t),
+                                     kind,
+                                     key_bytes.size(),
+                                     payload.bytes().size()};
+      auto temporary = path;
+      temporary += format_string(".%016x.tmp", std::random_device{}());
+      try {
+        std::filesystem::create_directories(path.parent_path());
+        {
+          std::ofstream out(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+          out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+          out.write(reinterpret_cast<const char*>(key_bytes.data()),
+                    static_cast<std::streamsize>(key_bytes.size()));
+          out.write(reinterpret_cast<const char*>(payload.bytes().data()),
+                    static_cast<std::streamsize>(payload.bytes().size()));
+          if (!out.good()) throw std::runtime_error("write failed");
+        }
+        std::filesystem::rename(temporary, path);
+      } catch (std::exception const& e) {
+        std::error_code ignored;
+        std::filesystem::remove(temporary, ignored);
+        log::warn(format_string("Cannot write geometry cache file \"%s\" (%s)", path.string(),
+                                e.what()));
+      }
+    }
+
+    template <class V, class Fn> V& lookup(std::vector<std::pair<key, V>>& entries, key&& k,
+                                           entry_kind kind, Fn&& compute) {
+      for (auto&& [entry, value] : entries)
+        if (entry == k) return value;
+      if (!_directory.has_value()) return entries.emplace_back(std::move(k), compute()).second;
+      auto key_bytes = k.bytes();
+      auto path = entry_path(key_bytes, kind);
+      auto value = load<V>(path, key_bytes, k, kind);
+      if (!value.has_value()) {
+        value = compute();
+        store(path, key_bytes, kind, value.value());
+      }
+      return entries.emplace_back(std::move(k), std::move(value.value())).second;
+    }
+
+    pairs_t& pairs_unlocked(structure<T>& s, std::vector<T> const& radii,
+                            shell_weights_t<T> const& weights) {
+      return lookup(_pairs, key(s, radii, weights), PAIRS, [&] { return s.pairs(radii, weights); });
+    }
+
+    periodic_pairs_t& periodic_pairs_unlocked(structure<T> const& s, std::vector<T> const& radii,
+                                              shell_weights_t<T> const& weights) {
+      return lookup(_periodic_pairs, key(s, radii, weights), PERIODIC_PAIRS,
+                    [&] { return s.periodic_pairs(radii, weights); });
+    }
+
+  public:
+    explicit geometry_cache(std::optional<std::filesystem::path> directory = std::nullopt)
+        : _directory(std::move(directory)) {}
+
+    [[nodiscard]] std::optional<std::filesystem::path> directory() {
+      std::lock_guard lock(_mutex);
+      return _directory;
+    }
+
+    void set_directory(std::optional<std::filesystem::path> directory) {
+      std::lock_guard lock(_mutex);
+      _directory = std::move(directory);
+    }
+
+    // detect computes the radii if they are not known yet, parameters identifies the detection
+    template <class Fn> std::vector<T> shell_radii(structure<T> const& s,
+                                                   std::vector<T> const& parameters, Fn&& detect) {
+      std::lock_guard lock(_mutex);
+      return lookup(_shell_radii, key(s, parameters, std::vector<usize_t>{}), SHELL_RADII,
+                    std::forward<Fn>(detect));
+    }
+
+    pairs_t pairs(structure<T>& s, std::vector<T> const& radii, shell_weights_t<T> const& weights) {
+      std::lock_guard lock(_mutex);
+      return pairs_unlocked(s, radii, weights);
+    }
+
+    periodic_pairs_t periodic_pairs(structure<T> const& s, std::vector<T> const& radii,
+                                    shell_weights_t<T> const& weights) {
+      std::lock_guard lock(_mutex);
+      return periodic_pairs_unlocked(s, radii, weights);
+    }
+
+    /*
+     * The number of ordered pairs i-j in each weighted shell. They are counted on the implicit pair
+     * list if the structure has one, and otherwise on the explicit one. Both are kept for the setup
+     * of the optimization, see optimization_config::from_config
+     */
+    counter<usize_t> neighbors(structure<T>& s, std::vector<T> const& radii,
+                               shell_weights_t<T> const& weights) {
+      std::lock_guard lock(_mutex);
+      auto shells = std::get<1>(helpers::make_index_mapping<usize_t>(weights | views::elements<0>));
+      counter<usize_t> neighbors;
+      if (auto const& periodic = periodic_pairs_unlocked(s, radii, weights); periodic.has_value()) {
+        auto const& [a, b, c] = periodic.value().shape;
+        auto num_cells = static_cast<std::size_t>(a) * b * c;
+        for (auto const& t : periodic.value().templates)
+          neighbors[shells[t.shell]] += t.symmetric ? num_cells : 2 * num_cells;
+      } else {
+        for (auto const& pair : std::get<0>(pairs_unlocked(s, radii, weights)))
+          neighbors[shells[pair.shell]] += 2;
+      }
+      return neighbors;
+    }
+
+    // drops all pair lists, e.g. once the optimizer holds its own
+    void clear() {
+      std::lock_guard lock(_mutex);
+      _pairs.clear();
+      _periodic_pairs.clear();
+    }
+
+    [[nodiscard]] std::size_t size() {
+      std::lock_guard lock(_mutex);
+      return _shell_radii.size() + _pairs.size() + _periodic_pairs.size();
+    }
+  };
+
+  // compute_prefactors, but the neighbors are counted on the pair lists of geometry
+  template <class T> cube_t<T> compute_prefactors(structure<T>& structure,
+                                                  std::vector<T> const& shell_radii,
+                                                  shell_weights_t<T> const& weights,
+                                                  geometry_cache<T>& geometry) {
+    return sqsgen::core::detail::compute_prefactors<T>(
+        geometry.neighbors(structure, shell_radii, weights), weights, structure.species);
+  }
+
+}  // namespace sqsgen::core
+
+#endif  // SQSGEN_CORE_GEOMETRY_H
@@ -0,0 +1,77 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_CORE_HELPERS_BOUNDED_QUEUE_H
+#define SQSGEN_CORE_HELPERS_BOUNDED_QUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace sqsgen::core::helpers {
+
+  /*
+   * A queue with a fixed capacity for many producers and a single consumer. Producers block while
+   * the queue is full, the consumer blocks while it is empty. Once closed, no further values are
+   * accepted, while the remaining ones can still be taken
+   */
+  template <class V> class bounded_queue {
+    std::size_t _capacity;
+    std::deque<V> _values;
+    bool _closed{false};
+    mutable std::mutex _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+
+  public:
+    explicit bounded_queue(std::size_t capacity) : _capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    // false if the queue was closed, the value is dropped then
+    bool push(V&& value) {
+      {
+        std::unique_lock lock(_mutex);
+        _not_full.wait(lock, [this] { return _closed || _values.size() < _capacity; });
+        if (_closed) return false;
+        _values.push_back(std::move(value));
+      }
+      _not_empty.notify_one();
+      return true;
+    }
+
+    // std::nullopt once the queue is closed and drained
+    std::optional<V> pop() {
+      std::optional<V> value;
+      {
+        std::unique_lock lock(_mutex);
+        _not_empty.wait(lock, [this] { return _closed || !_values.empty(); });
+        if (_values.empty()) return std::nullopt;
+        value = std::move(_values.front());
+        _values.pop_front();
+      }
+      _not_full.notify_one();
+      return value;
+    }
+
+    void close() {
+      {
+        std::scoped_lock lock(_mutex);
+        _closed = true;
+      }
+      _not_full.notify_all();
+      _not_empty.notify_all();
+    }
+
+    [[nodiscard]] bool empty() const {
+      std::scoped_lock lock(_mutex);
+      return _values.empty();
+    }
+
+    [[nodiscard]] std::size_t capacity() const { return _capacity; }
+  };
+
+}  // namespace sqsgen::core::helpers
+
+#endif  // SQSGEN_CORE_HELPERS_BOUNDED_QUEUE_H
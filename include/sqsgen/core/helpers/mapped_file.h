@@ -0,0 +1,106 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_CORE_HELPERS_MAPPED_FILE_H
+#define SQSGEN_CORE_HELPERS_MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+
+#include "sqsgen/log.h"
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace sqsgen::core::helpers {
+
+  /*
+   * A read-only view of a whole file, mapped into memory. The pages are only read once they are
+   * accessed, and the mapping is released together with the object
+   */
+  class mapped_file {
+    const std::byte* _data{nullptr};
+    std::size_t _size{0};
+#ifdef _WIN32
+    HANDLE _file{INVALID_HANDLE_VALUE};
+    HANDLE _mapping{nullptr};
+#else
+    int _fd{-1};
+#endif
+
+    void release() {
+#ifdef _WIN32
+      if (_data != nullptr) UnmapViewOfFile(_data);
+      if (_mapping != nullptr) CloseHandle(_mapping);
+      if (_file != INVALID_HANDLE_VALUE) CloseHandle(_file);
+      _mapping = nullptr;
+      _file = INVALID_HANDLE_VALUE;
+#else
+      if (_data != nullptr) munmap(const_cast<std::byte*>(_data), _size);
+      if (_fd >= 0) close(_fd);
+      _fd = -1;
+#endif
+      _data = nullptr;
+      _size = 0;
+    }
+
+  public:
+    explicit mapped_file(std::filesystem::path const& path) {
+      auto fail = [&](std::string const& what) {
+        release();
+        throw std::runtime_error(format_string("Cannot %s file \"%s\"", what, path.string()));
+      };
+#ifdef _WIN32
+      _file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (_file == INVALID_HANDLE_VALUE) fail("open");
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(_file, &size)) fail("stat");
+      _size = static_cast<std::size_t>(size.QuadPart);
+      if (_size == 0) return;
+      _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (_mapping == nullptr) fail("map");
+      _data = static_cast<const std::byte*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+      if (_data == nullptr) fail("map");
+#else
+      _fd = open(path.c_str(), O_RDONLY);
+      if (_fd < 0) fail("open");
+      struct stat info{};
+      if (fstat(_fd, &info) != 0) fail("stat");
+      _size = static_cast<std::size_t>(info.st_size);
+      // a zero length mapping is invalid
+      if (_size == 0) return;
+      auto data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fd, 0);
+      if (data == MAP_FAILED) {
+        _size = 0;
+        fail("map");
+      }
+      _data = static_cast<const std::byte*>(data);
+#endif
+    }
+
+    mapped_file(mapped_file const&) = delete;
+    mapped_file& operator=(mapped_file const&) = delete;
+
+    ~mapped_file() { release(); }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const { return {_data, _size}; }
+
+    [[nodiscard]] std::size_t size() const { return _size; }
+  };
+
+}  // namespace sqsgen::core::helpers
+
+#endif  // SQSGEN_CORE_HELPERS_MAPPED_FILE_H
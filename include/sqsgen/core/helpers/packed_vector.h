@@ -0,0 +1,72 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_CORE_HELPERS_PACKED_VECTOR_H
+#define SQSGEN_CORE_HELPERS_PACKED_VECTOR_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace sqsgen::core::helpers {
+
+  /*
+   * An immutable vector of small unsigned integers. Each entry occupies as many bits as the largest
+   * entry needs, entries never cross the boundary of a 64 bit word. Two vectors holding the same
+   * values always have the same words, hence hashing and comparison work on the words directly
+   */
+  template <class T>
+    requires std::is_unsigned_v<T>
+  class packed_vector {
+    using word_t = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = 64;
+
+    std::vector<word_t> _words;
+    std::size_t _size{0};
+    std::uint8_t _bits{1};
+
+    [[nodiscard]] std::size_t per_word() const { return WORD_BITS / _bits; }
+
+  public:
+    packed_vector() = default;
+
+    explicit packed_vector(std::vector<T> const& values) : _size(values.size()) {
+      if (values.empty()) return;
+      auto largest = static_cast<word_t>(*std::max_element(values.begin(), values.end()));
+      _bits = static_cast<std::uint8_t>(std::max<int>(1, std::bit_width(largest)));
+      _words.resize((_size + per_word() - 1) / per_word(), 0);
+      for (std::size_t i = 0; i < _size; ++i)
+        _words[i / per_word()] |= static_cast<word_t>(values[i]) << (i % per_word() * _bits);
+    }
+
+    T operator[](std::size_t i) const {
+      const word_t mask = (word_t{1} << _bits) - 1;
+      return static_cast<T>((_words[i / per_word()] >> (i % per_word() * _bits)) & mask);
+    }
+
+    [[nodiscard]] std::vector<T> unpack() const {
+      std::vector<T> values(_size);
+      for (std::size_t i = 0; i < _size; ++i) values[i] = (*this)[i];
+      return values;
+    }
+
+    [[nodiscard]] std::size_t size() const { return _size; }
+
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+    [[nodiscard]] std::uint8_t bits() const { return _bits; }
+
+    bool operator==(packed_vector const& other) const = default;
+
+    template <typename H> friend H AbslHashValue(H h, packed_vector const& v) {
+      return H::combine(H::combine_contiguous(std::move(h), v._words.data(), v._words.size()),
+                        v._size);
+    }
+  };
+
+}  // namespace sqsgen::core::helpers
+
+#endif  // SQSGEN_CORE_HELPERS_PACKED_VECTOR_H
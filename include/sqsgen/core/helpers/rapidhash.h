@@ -1,3 +1,5 @@
+#pragma once
+
 /*
  * rapidhash V3 - Very fast, high quality, platform-independent hashing algorithm.
  *
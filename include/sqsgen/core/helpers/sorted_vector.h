@@ -50,6 +50,8 @@ namespace sqsgen::core::helpers {
 
     auto back() const { return _values.back(); }
 
+    void pop_back() { _values.pop_back(); }
+
     auto at(auto index) const { return _values.at(index); }
 
     iterator insert(T&& t) {
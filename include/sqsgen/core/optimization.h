@@ -71,11 +71,71 @@ namespace sqsgen::core::optimization {
     return std::make_tuple(sorted, bounds, sort_order);
   }
 
-  void count_bonds(cube_t<usize_t>& bonds, auto const& pairs, configuration_t const& species) {
-    bonds.setConstant(0);
+  namespace detail {
+    // interleaves the lower 21 bits of x with two zero bits each
+    inline std::uint64_t spread_bits(std::uint64_t x) {
+      x &= 0x1fffff;
+      x = (x | x << 32) & 0x1f00000000ffff;
+      x = (x | x << 16) & 0x1f0000ff0000ff;
+      x = (x | x << 8) & 0x100f00f00f00f00f;
+      x = (x | x << 4) & 0x10c30c30c30c30c3;
+      x = (x | x << 2) & 0x1249249249249249;
+      return x;
+    }
+
+    template <class T> std::uint64_t morton_code(Eigen::Matrix<T, 1, 3> const& frac_coords) {
+      constexpr std::uint64_t resolution = std::uint64_t{1} << 21;
+      std::uint64_t code{0};
+      for (auto k = 0; k < 3; ++k) {
+        T x = frac_coords(k) - std::floor(frac_coords(k));
+        auto cell = std::min(static_cast<std::uint64_t>(x * static_cast<T>(resolution)),
+                             resolution - 1);
+        code |= spread_bits(cell) << k;
+      }
+      return code;
+    }
+  }  // namespace detail
+
+  /*
+   * Reorders the sites within each of the bounds along a Morton (Z-order) curve of their fractional
+   * coordinates. Thus, sites close in space are close in memory, and the species lookups of a pair
+   * list sorted by site index stay in the cache. The sort order is updated accordingly
+   */
+  template <class T> void sort_by_locality(structure<T>& sorted, std::vector<usize_t>& sort_order,
+                                           std::vector<bounds_t<usize_t>> const& bounds) {
+    auto codes = core::helpers::as<std::vector>{}(
+        core::helpers::range(static_cast<usize_t>(sorted.size()))
+        | views::transform([&](auto&& i) -> std::uint64_t {
+            return detail::morton_code<T>(sorted.frac_coords.row(i));
+          }));
+    auto order = core::helpers::as<std::vector>{}(
+        core::helpers::range(static_cast<usize_t>(sorted.size())));
+    for (auto&& [lower, upper] : bounds)
+      std::stable_sort(order.begin() + lower, order.begin() + upper,
+                       [&](auto a, auto b) { return codes[a] < codes[b]; });
+    if (ranges::equal(order, core::helpers::range(static_cast<usize_t>(sorted.size())))) return;
+
+    auto sites = core::helpers::as<std::vector>{}(sorted.sites());
+    auto reordered_sites = core::helpers::as<std::vector>{}(
+        order | views::transform([&](auto&& i) { return sites[i]; }));
+    auto reordered = core::helpers::as<std::vector>{}(
+        order | views::transform([&](auto&& i) { return sort_order[i]; }));
+    sorted = structure<T>(sorted.lattice, reordered_sites);
+    sort_order = std::move(reordered);
+  }
+
+  void count_bonds(cube_t<usize_t>& bonds, auto const& pairs, configuration_t const& species,
+                   cube_t<usize_t> const& static_bonds) {
+    bonds = static_bonds;
     for (auto& [i, j, s] : pairs) bonds(s, species[i], species[j])++;
   }
 
+  inline void count_bonds(cube_t<usize_t>& bonds, periodic_pair_list<usize_t> const& pairs,
+                          configuration_t const& species, cube_t<usize_t> const& static_bonds) {
+    bonds = static_bonds;
+    pairs.for_each([&](usize_t i, usize_t j, usize_t s) { bonds(s, species[i], species[j])++; });
+  }
+
   template <class T> T compute_objective(cube_t<T>& sro, cube_t<usize_t> const& bonds,
                                          cube_t<T> const& prefactors, cube_t<T> const& pair_weights,
                                          cube_t<T> const& target, auto num_shells,
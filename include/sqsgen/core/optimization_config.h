@@ -5,6 +5,7 @@
 #ifndef SQSGEN_CORE_OPTIMIZATION_CONFIG_H
 #define SQSGEN_CORE_OPTIMIZATION_CONFIG_H
 
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/optimization.h"
 #include "sqsgen/core/shuffle.h"
 #include "sqsgen/core/structure.h"
@@ -17,6 +18,9 @@ namespace sqsgen::core {
     namespace ranges = std::ranges;
     namespace views = ranges::views;
 
+    // smaller pair lists fit into the cache and are traversed faster explicitly
+    constexpr std::size_t PERIODIC_PAIRS_THRESHOLD = 1 << 17;
+
     template <ranges::sized_range... R> bool same_length(R&&... r) {
       if constexpr (sizeof...(R) == 0)
         return false;
@@ -39,7 +43,11 @@ namespace sqsgen::core {
     configuration_t species_packed;
     index_mapping_t<specie_t, specie_t> species_map;
     index_mapping_t<usize_t, usize_t> shell_map;
-    std::vector<atom_pair<usize_t>> pairs;
+    std::vector<packed_pair> pairs;
+    // if set, pairs is left empty and the pairs are generated from the primitive cell
+    std::optional<periodic_pair_list<usize_t>> periodic_pairs;
+    // bonds between sites which never change, the corresponding pairs are not part of pairs
+    cube_t<usize_t> static_bonds;
     cube_t<T> pair_weights;
     cube_t<T> prefactors;
     cube_t<T> target_objective;
@@ -56,7 +64,18 @@ namespace sqsgen::core {
       return std::nullopt;
     }
 
-    static std::vector<optimization_config> from_config(configuration<T> config) {
+    // if with_pairs is false, the (expensive) pair list is not computed and left empty. Pair lists
+    // are looked up in geometry first, or in the context of config if none is passed. Without any
+    // context, the cache directory of config is still consulted
+    static std::vector<optimization_config> from_config(configuration<T> config,
+                                                        bool with_pairs = true,
+                                                        geometry_cache<T>* geometry = nullptr) {
+      std::shared_ptr<geometry_cache<T>> own;
+      if (geometry == nullptr) geometry = config.geometry.get();
+      if (geometry == nullptr && config.geometry_cache.has_value()) {
+        own = std::make_shared<geometry_cache<T>>(config.geometry_cache.value());
+        geometry = own.get();
+      }
       auto [structures, sorted, bounds, sort_order] = decompose_sort_and_bounds(config);
       if (!core::detail::same_length(structures, sorted, bounds, sort_order, config.shell_radii,
                                      config.shell_weights, config.prefactors,
@@ -67,10 +86,10 @@ namespace sqsgen::core {
       std::vector<optimization_config> configs;
       configs.reserve(num_sublattices);
       for (auto i = 0u; i < num_sublattices; i++) {
-        auto [species_packed, species_map, species_rmap, pairs, shells_map, shells_rmap,
-              pair_weights]
-            = shared(sorted[i], config.shell_radii[i], config.shell_weights[i],
-                     config.pair_weights[i]);
+        auto [species_packed, species_map, species_rmap, pairs, periodic_pairs, static_bonds,
+              shells_map, shells_rmap, pair_weights]
+            = shared(structures[i], sorted[i], sort_order[i], {bounds[i]}, config.shell_radii[i],
+                     config.shell_weights[i], config.pair_weights[i], with_pairs, geometry);
         std::vector<sublattice> sublattices;
         if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
           sublattices = config.composition;
@@ -87,6 +106,8 @@ namespace sqsgen::core {
                                 std::make_pair(std::move(species_map), std::move(species_rmap)),
                                 std::make_pair(std::move(shells_map), std::move(shells_rmap)),
                                 std::move(pairs),
+                                std::move(periodic_pairs),
+                                std::move(static_bonds),
                                 std::move(config.pair_weights[i]),
                                 std::move(config.prefactors[i]),
                                 std::move(config.target_objective[i]),
@@ -124,19 +145,80 @@ namespace sqsgen::core {
                 })));
       }
     }
-    static auto shared(structure<T> sorted, std::vector<T> const& radii,
-                       shell_weights_t<T> const& weights, cube_t<T> const& pair_weights) {
+    // the sorted structure and sort order are reordered in place, if the sites are relabeled
+    static auto shared(structure<T> unsorted, structure<T>& sorted,
+                       std::vector<usize_t>& sort_order,
+                       std::vector<bounds_t<usize_t>> const& bounds, std::vector<T> const& radii,
+                       shell_weights_t<T> const& weights, cube_t<T> const& pair_weights,
+                       bool with_pairs, geometry_cache<T>* geometry) {
+      // the implicit pair list of a supercell is cheap to build, but it can only be used if the
+      // sites were not reordered
+      std::optional<periodic_pair_list<usize_t>> periodic_pairs;
+      if (ranges::equal(sort_order, helpers::range(static_cast<usize_t>(sort_order.size()))))
+        periodic_pairs = geometry ? geometry->periodic_pairs(unsorted, radii, weights)
+                                  : unsorted.periodic_pairs(radii, weights);
+      if (periodic_pairs.has_value()
+          && periodic_pairs.value().num_pairs() < detail::PERIODIC_PAIRS_THRESHOLD)
+        periodic_pairs = std::nullopt;
+      // every rank relabels the sites, since ranks without pairs map the list of their node leader
+      if (!periodic_pairs.has_value()) optimization::sort_by_locality(sorted, sort_order, bounds);
+
       auto [species_map, species_rmap] = helpers::make_index_mapping<specie_t>(sorted.species);
       auto species_packed
           = helpers::as<std::vector>{}(sorted.species | views::transform([&species_map](auto&& s) {
                                          return species_map.at(s);
                                        }));
-      auto [pairs, shells_map, shells_rmap] = sorted.pairs(radii, weights);
-      std::sort(pairs.begin(), pairs.end(), [](auto p, auto q) {
-        return helpers::absolute(p.i - p.j) < helpers::absolute(q.i - q.j) && p.i < q.i;
+      cube_t<usize_t> static_bonds(weights.size(), sorted.num_species, sorted.num_species);
+      static_bonds.setConstant(0);
+      if (!with_pairs || periodic_pairs.has_value()) {
+        auto [shells_map, shells_rmap]
+            = helpers::make_index_mapping<usize_t>(weights | views::elements<0>);
+        return std::make_tuple(
+            species_packed, species_map, species_rmap, std::vector<packed_pair>{}, periodic_pairs,
+            static_bonds, shells_map, shells_rmap,
+            optimization::scaled_pair_weights(pair_weights, weights, sorted.num_species));
+      }
+      if (sorted.size() > MAX_PACKED_SITES)
+        throw std::invalid_argument(format_string(
+            "A structure with %i sites exceeds the maximum of %i sites for a pair list",
+            sorted.size(), MAX_PACKED_SITES));
+      if (weights.size() > MAX_PACKED_SHELLS)
+        throw std::invalid_argument(
+            format_string("At most %i coordination shells can be weighted", MAX_PACKED_SHELLS));
+
+      // the pairs are computed on the unsorted structure, since it still knows its supercell
+      // shape, and are then relabeled to the sorted site indices
+      auto [pairs, shells_map, shells_rmap]
+          = geometry ? geometry->pairs(unsorted, radii, weights) : unsorted.pairs(radii, weights);
+      std::vector<usize_t> sorted_index(sort_order.size());
+      for (usize_t k = 0; k < sort_order.size(); ++k) sorted_index[sort_order[k]] = k;
+      // a site can only change if its window holds at least two different species. Pairs of two
+      // sites which never change contribute the same bonds in every iteration
+      std::vector<bool> mobile(sorted.size(), false);
+      for (auto&& [lower, upper] : bounds) {
+        auto first = species_packed.begin() + lower, last = species_packed.begin() + upper;
+        if (std::any_of(first, last, [&](auto specie) { return specie != *first; }))
+          std::fill(mobile.begin() + lower, mobile.begin() + upper, true);
+      }
+      std::vector<packed_pair> packed;
+      packed.reserve(pairs.size());
+      for (auto&& [i, j, shell] : pairs) {
+        auto [a, b] = std::minmax(sorted_index[i], sorted_index[j]);
+        if (!mobile[a] && !mobile[b]) {
+          static_bonds(shell, species_packed[a], species_packed[b])++;
+          continue;
+        }
+        packed.push_back({static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b),
+                          static_cast<std::uint32_t>(shell)});
+      }
+      std::vector<atom_pair<usize_t>>{}.swap(pairs);
+      packed.shrink_to_fit();
+      ranges::sort(packed, [](auto const& p, auto const& q) {
+        return p.i < q.i || (p.i == q.i && p.j < q.j);
       });
       return std::make_tuple(
-          species_packed, species_map, species_rmap, pairs, shells_map, shells_rmap,
+          species_packed, species_map, species_rmap, packed, periodic_pairs, static_bonds,
+          shells_map, shells_rmap,
           optimization::scaled_pair_weights(pair_weights, weights, sorted.num_species));
     }
   };
@@ -62,10 +62,12 @@ namespace sqsgen::core {
 
     auto results_for_objective(T objective) {
       std::shared_lock lock(mutex_);
+      std::size_t evicted{0};
+      if (auto it = evicted_.find(objective); it != evicted_.end()) evicted = it->second;
       if (auto it = data_.find(objective); it != data_.end())
-        return it->second.size();
+        return it->second.size() + evicted;
       else
-        return std::size_t{0};
+        return evicted;
     }
 
     [[nodiscard]] std::size_t num_results() const {
@@ -81,21 +83,67 @@ namespace sqsgen::core {
       return objectives_.at(n);
     }
 
+    // flat list of all results belonging to the num_objectives best objectives
+    std::vector<sqs_result<T, Mode>> best(std::size_t num_objectives) const {
+      std::shared_lock lock(mutex_);
+      std::vector<sqs_result<T, Mode>> best;
+      for (std::size_t n = 0; n < std::min(num_objectives, objectives_.size()); ++n) {
+        auto const &collection = data_.at(objectives_.at(n));
+        best.insert(best.end(), collection.begin(), collection.end());
+      }
+      return best;
+    }
+
     pack_data_t results() {
       pack_data_t results(std::vector<sqs_result_entry_t<T, Mode>>{});
       std::shared_lock lock(mutex_);
       results.reserve(data_.size());
       for (auto const &[objective, collection] : data_)
-        results.insert(
-            {objective, std::vector<sqs_result<T, Mode>>(collection.begin(), collection.end())});
+        if (!collection.empty())
+          results.insert({objective, std::vector<sqs_result<T, Mode>>(collection.begin(),
+                                                                      collection.end())});
       return results;
     }
     pack_data_t remove_duplicates() { return results(); }
 
+    // drops the results of all but the num_objectives best objectives
+    void truncate(std::size_t num_objectives) ABSL_LOCKS_EXCLUDED(mutex_) {
+      std::unique_lock lock(mutex_);
+      while (objectives_.size() > num_objectives) {
+        data_.erase(objectives_.back());
+        evicted_.erase(objectives_.back());
+        objectives_.pop_back();
+      }
+    }
+
+    /*
+     * Drops the stored results, but keeps their objectives. The dropped results still count
+     * towards results_for_objective, such that the stopping rules are not affected. Returns the
+     * number of dropped results
+     */
+    std::size_t evict() ABSL_LOCKS_EXCLUDED(mutex_) {
+      std::unique_lock lock(mutex_);
+      std::size_t evicted{0};
+      for (auto &[objective, collection] : data_) {
+        evicted_[objective] += collection.size();
+        evicted += collection.size();
+        collection = {};
+      }
+      return evicted;
+    }
+
+    void clear() ABSL_LOCKS_EXCLUDED(mutex_) {
+      std::unique_lock lock(mutex_);
+      objectives_.clear();
+      data_.clear();
+      evicted_.clear();
+    }
+
   private:
     mutable std::shared_mutex mutex_;
     helpers::sorted_vector<T> objectives_;
     absl::flat_hash_map<T, absl::flat_hash_set<sqs_result<T, Mode>>> data_;
+    absl::flat_hash_map<T, std::size_t> evicted_;
   };
 
   template <class, SublatticeMode> struct sqs_result_factory;
@@ -137,32 +185,122 @@ namespace sqsgen::core {
         = std::conditional_t<Mode == SUBLATTICE_MODE_SPLIT,
                              std::vector<optimization_config_data<T>>, optimization_config_data<T>>;
 
+    // maps a configuration of the sorted structure back to the site order and atomic species of
+    // the input structure
+    template <class T> configuration_t restore_order(configuration_t const &species,
+                                                     optimization_config_data<T> const &config) {
+      configuration_t reversed(species.size());
+      for (auto i = 0; i < species.size(); i++)
+        reversed[config.sort_order[i]] = config.species_map.second.at(species[i]);
+      return reversed;
+    }
+
+    // inverse of restore_order
+    template <class T> configuration_t sorted_order(configuration_t const &species,
+                                                    optimization_config_data<T> const &config) {
+      configuration_t sorted(species.size());
+      for (auto i = 0; i < species.size(); i++)
+        sorted[i] = config.species_map.first.at(species[config.sort_order[i]]);
+      return sorted;
+    }
+
+    // computes the objective and the SRO parameters of a configuration of the sorted structure
+    template <class T> std::tuple<T, cube_t<T>> evaluate(optimization_config_data<T> const &config,
+                                                         configuration_t const &species) {
+      auto num_shells = config.shell_weights.size();
+      auto num_species = config.sorted.num_species;
+      cube_t<usize_t> bonds(num_shells, num_species, num_species);
+      cube_t<T> sro(num_shells, num_species, num_species);
+      if (config.periodic_pairs.has_value())
+        optimization::count_bonds(bonds, config.periodic_pairs.value(), species,
+                                  config.static_bonds);
+      else
+        optimization::count_bonds(bonds, config.pairs, species, config.static_bonds);
+      auto objective
+          = optimization::compute_objective(sro, bonds, config.prefactors, config.pair_weights,
+                                            config.target_objective, num_shells, num_species);
+      return {objective, std::move(sro)};
+    }
+
+    template <class T> cube_t<T> compute_sro(optimization_config_data<T> const &config,
+                                             configuration_t const &species) {
+      return std::get<1>(evaluate<T>(config, species));
+    }
+
+    // what is needed to regenerate a compact result from its iteration index
+    struct replay_key {
+      IterationMode iteration_mode;
+      std::optional<std::uint64_t> seed;
+    };
+
+    // regenerates the configuration (of the sorted structure) examined at the given iteration
+    template <class T> configuration_t replay(optimization_config_data<T> const &config,
+                                              replay_key const &key, iterations_t iteration) {
+      configuration_t species(config.species_packed);
+      shuffler shuffler(config.bounds, key.seed);
+      if (key.iteration_mode == ITERATION_MODE_RANDOM) {
+        if (!key.seed.has_value())
+          throw std::invalid_argument(
+              "a compact result of a random run can only be regenerated if the seed is known");
+        shuffler.shuffle(species, config.species_packed, iteration);
+      } else
+        shuffler.unrank_permutation<ITERATION_MODE_SYSTEMATIC>(species, rank_t{iteration} + 1);
+      return species;
+    }
+
     template <class, SublatticeMode> class sqs_result_wrapper {};
 
     template <class T> class sqs_result_wrapper<T, SUBLATTICE_MODE_INTERACT>
         : public sqs_result<T, SUBLATTICE_MODE_INTERACT> {
       std::shared_ptr<core::structure<T>> _structure;
       opt_config_t<T, SUBLATTICE_MODE_INTERACT> _opt_config;
+      replay_key _key;
 
     public:
       explicit sqs_result_wrapper(sqs_result<T, SUBLATTICE_MODE_INTERACT> &&result,
                                   std::shared_ptr<core::structure<T>> structure,
-                                  opt_config_t<T, SUBLATTICE_MODE_INTERACT> opt_config)
+                                  opt_config_t<T, SUBLATTICE_MODE_INTERACT> opt_config,
+                                  replay_key key)
           : sqs_result<T, SUBLATTICE_MODE_INTERACT>(std::move(result)),
             _structure(structure),
-            _opt_config(opt_config) {}
+            _opt_config(opt_config),
+            _key(key) {}
+
+      // the configuration of the sorted structure, as it was examined during the optimization
+      configuration_t sorted_configuration() const {
+        if (this->compact()) return replay(*_opt_config, _key, this->iteration);
+        return sorted_order<T>(this->species.unpack(), *_opt_config);
+      }
+
+      // SRO parameters are recomputed if they were not retained
+      cube_t<T> sro_parameters() const {
+        if (this->sro.size() > 0) return this->sro;
+        return compute_sro<T>(*_opt_config, sorted_configuration());
+      }
+
+      // regenerates the species of a compact result and the SRO parameters on first access
+      void materialize() {
+        if (!this->compact() && this->sro.size() > 0) return;
+        auto sorted = sorted_configuration();
+        this->sro = compute_sro<T>(*_opt_config, sorted);
+        if (this->compact())
+          this->species = packed_configuration_t(restore_order<T>(sorted, *_opt_config));
+      }
 
       core::structure<T> structure() {
         return core::structure<T>{_opt_config->structure.lattice,
-                                  _opt_config->structure.frac_coords, this->species,
+                                  _opt_config->structure.frac_coords, configuration(),
                                   _opt_config->structure.pbc};
       }
 
-      configuration_t configuration() { return this->species; }
+      configuration_t configuration() {
+        materialize();
+        return this->species.unpack();
+      }
 
       std::string rank() {
         return core::rank_permutation(
-                   as<std::vector>{}(this->species | views::transform([&](auto &&s) {
+                   as<std::vector>{}(configuration() | views::transform([&](auto &&s) {
                                        return this->_opt_config->species_map.first.at(s);
                                      })))
             .str();
@@ -177,6 +315,7 @@ namespace sqsgen::core {
       }
 
       sro_parameter<T> parameter(usize_t shell, specie_t i, specie_t j) {
+        materialize();
         auto shell_index = this->shell_index(shell);
         if (shell_index.has_value()) {
           auto ii = species_index(i);
@@ -206,7 +345,10 @@ namespace sqsgen::core {
                                  | views::transform([&](auto &&s) { return parameter(s, i, j); }));
       }
 
-      cube_t<T> parameter() { return this->sro; }
+      cube_t<T> parameter() {
+        materialize();
+        return this->sro;
+      }
 
       std::optional<usize_t> shell_index(usize_t shell) {
         auto result = this->_opt_config->shell_map.first.find(shell);
@@ -236,14 +378,16 @@ namespace sqsgen::core {
       std::vector<sqs_result_wrapper<T, SUBLATTICE_MODE_INTERACT>> sublattices;
       explicit sqs_result_wrapper(sqs_result<T, SUBLATTICE_MODE_SPLIT> &&result,
                                   std::shared_ptr<core::structure<T>> structure,
-                                  opt_config_t<T, SUBLATTICE_MODE_SPLIT> opt_config)
+                                  opt_config_t<T, SUBLATTICE_MODE_SPLIT> opt_config,
+                                  std::vector<replay_key> const &keys)
           : sqs_result<T, SUBLATTICE_MODE_SPLIT>(std::move(result)),
             _structure(structure),
             _opt_config(opt_config)
 
       {
         sublattices = make_sublattice_results(
-            std::move(sqs_result<T, SUBLATTICE_MODE_SPLIT>::sublattices), structure, opt_config);
+            std::move(sqs_result<T, SUBLATTICE_MODE_SPLIT>::sublattices), structure, opt_config,
+            keys);
       }
 
       configuration_t configuration() {
@@ -254,9 +398,9 @@ namespace sqsgen::core {
             throw std::out_of_range(
                 "a split mode result must have exactly one sublattice. Sublattices cannot contain "
                 "sublattices themselves");
+          auto species = sublattice.configuration();
           auto index{0};
-          for (auto site_index : sls.front().sites)
-            new_species[site_index] = sublattice.species[index++];
+          for (auto site_index : sls.front().sites) new_species[site_index] = species[index++];
         }
         return new_species;
       }
@@ -270,14 +414,14 @@ namespace sqsgen::core {
       static auto make_sublattice_results(
           std::vector<sqs_result<T, SUBLATTICE_MODE_INTERACT>> &&results,
           std::shared_ptr<core::structure<T>> structure,
-          opt_config_t<T, SUBLATTICE_MODE_SPLIT> opt_config) {
-        if (results.size() != opt_config.size())
+          opt_config_t<T, SUBLATTICE_MODE_SPLIT> opt_config, std::vector<replay_key> const &keys) {
+        if (results.size() != opt_config.size() || results.size() != keys.size())
           throw std::invalid_argument("invalid number of sublattices and optimization configs");
 
         return core::helpers::as<std::vector>{}(
             helpers::range(results.size()) | views::transform([&](auto &&index) {
-              return sqs_result_wrapper<T, SUBLATTICE_MODE_INTERACT>(std::move(results[index]),
-                                                                     structure, opt_config[index]);
+              return sqs_result_wrapper<T, SUBLATTICE_MODE_INTERACT>(
+                  std::move(results[index]), structure, opt_config[index], keys[index]);
             }));
       }
     };
@@ -289,18 +433,34 @@ namespace sqsgen::core {
         = sorted_vector<sqs_result_pack_wrapper_entry_t<T, Mode>,
                         decltype(core::detail::by_objective)>;
 
+    // one key per sublattice, the seeds are assigned as in optimization_config::from_config
+    template <class T, SublatticeMode Mode>
+    std::conditional_t<Mode == SUBLATTICE_MODE_SPLIT, std::vector<replay_key>, replay_key>
+    replay_keys(configuration<T> const &config) {
+      const auto key = [&](std::size_t index) {
+        return replay_key{config.iteration_mode,
+                          optimization_config<T, Mode>::seed_for_sublattice(config.seed, index)};
+      };
+      if constexpr (Mode == SUBLATTICE_MODE_SPLIT)
+        return helpers::as<std::vector>{}(helpers::range(config.composition.size())
+                                          | views::transform(key));
+      else
+        return key(0);
+    }
+
     template <class T, SublatticeMode Mode>
     sqs_result_pack_wrapper_data_t<T, Mode> from_result_collection(
         sqs_result_pack_data_t<T, Mode> &&results, std::shared_ptr<structure<T>> structure,
-        opt_config_t<T, Mode> const &opt_config) {
+        opt_config_t<T, Mode> const &opt_config, configuration<T> const &config) {
+      auto keys = replay_keys<T, Mode>(config);
       sqs_result_pack_wrapper_data_t<T, Mode> converted;
       converted.reserve(results.size());
       for (auto &&[objective, collection] : results) {
         std::vector<sqs_result_wrapper<T, Mode>> converted_collection;
         converted_collection.reserve(collection.size());
         while (collection.size() > 0) {
-          converted_collection.push_back(
-              sqs_result_wrapper<T, Mode>{std::move(collection.back()), structure, opt_config});
+          converted_collection.push_back(sqs_result_wrapper<T, Mode>{
+              std::move(collection.back()), structure, opt_config, keys});
           collection.pop_back();
         }
         converted.insert(sqs_result_pack_wrapper_entry_t<T, Mode>{objective, converted_collection});
@@ -347,6 +507,8 @@ namespace sqsgen::core {
   public:
     sqs_statistics_data<T> statistics;
     pack_data_t results;
+    // the best results under each variant of the objective function, see configuration::variants
+    std::vector<sqs_result_pack> variants;
 
   public:
     typedef typename pack_data_t::iterator iterator;
@@ -374,18 +536,17 @@ namespace sqsgen::core {
               std::forward<core::detail::opt_config_arg_t<T, SMode>>(opt_config))),
           _structure(std::make_shared<structure<T>>(config.structure.structure())),
           results(core::detail::from_result_collection(std::forward<decltype(results)>(results),
-                                                       _structure, _optimization_config)) {}
+                                                       _structure, _optimization_config, config)) {}
 
     sqs_result_pack(configuration<T> &&configuration, pack_raw_data_t &&results,
                     sqs_statistics_data<T> &&stats)
         : statistics(stats),
           config(std::forward<core::configuration<T>>(configuration)),
           _optimization_config(core::detail::from_opt_config<T, SMode>(
-              core::detail::opt_config_from_config<T, SMode>(
-                  std::forward<decltype(config)>(config)))),
+              core::detail::opt_config_from_config<T, SMode>(core::configuration<T>{config}))),
           _structure(std::make_shared<structure<T>>(config.structure.structure())),
           results(core::detail::from_result_collection(std::forward<decltype(results)>(results),
-                                                       _structure, _optimization_config)) {}
+                                                       _structure, _optimization_config, config)) {}
   };
 
 }  // namespace sqsgen::core
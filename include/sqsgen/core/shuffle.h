@@ -6,6 +6,7 @@
 #define SQSGEN_CORE_SHUFFLE_H
 
 #include <random>
+#include <span>
 
 #include "sqsgen/core/helpers/rapidhash.h"
 #include "sqsgen/core/permutation.h"
@@ -38,16 +39,7 @@ namespace sqsgen::core {
         : _seed(seed.value_or(make_random_seed())), _bounds(std::move(bounds)) {}
     template <IterationMode Mode> void shuffle(configuration_t &configuration) {
       if constexpr (Mode == ITERATION_MODE_RANDOM) {
-        for (auto &bound : _bounds) {
-          auto [lower_bound, upper_bound] = bound;
-          assert(upper_bound > lower_bound);
-          auto window_size = upper_bound - lower_bound;
-          for (usize_t i = window_size; i > 1; i--) {
-            usize_t p = random_bounded(i, _seed);  // number in [0,i)
-            std::swap(configuration[lower_bound + i - 1],
-                      configuration[p + lower_bound]);  // swap the values at i-1 and p
-          }
-        }
+        shuffle_windows(configuration, _seed);
       } else if constexpr (Mode == ITERATION_MODE_SYSTEMATIC) {
         assert(_bounds.size() == 1);
         auto [lower_bound, upper_bound] = _bounds.front();
@@ -58,6 +50,42 @@ namespace sqsgen::core {
       }
     }
 
+    /*
+     * Counter based variant: resets the configuration to the initial one and shuffles it with a
+     * stream keyed by the seed and the global iteration index. The result is a pure function of
+     * (seed, iteration), hence independent of how the iterations are split among threads and ranks
+     */
+    void shuffle(configuration_t &configuration, configuration_t const &initial,
+                 iterations_t iteration) const {
+      std::copy(initial.begin(), initial.end(), configuration.begin());
+      auto stream = rapid_mix(_seed ^ rapid_secret[2], iteration ^ rapid_secret[3]);
+      shuffle_windows(configuration, stream);
+    }
+
+    /*
+     * Shuffles several configurations at once, interleaving their swaps to break up the dependency
+     * chain of a single shuffle. rapidrand is counter based, hence each configuration can draw from
+     * its own block of the stream. The result is the same as shuffling them one after another
+     */
+    void shuffle(std::span<configuration_t> configurations) {
+      const auto num_draws = helpers::fold_left(_bounds, std::uint64_t{0}, [](auto sum, auto &&b) {
+        return sum + (b.second > b.first ? b.second - b.first - 1 : 0);
+      });
+      std::vector<std::uint64_t> seeds(configurations.size());
+      for (usize_t c = 0; c < configurations.size(); ++c)
+        seeds[c] = _seed + c * num_draws * rapid_secret[0];
+      for (auto &bound : _bounds) {
+        auto [lower_bound, upper_bound] = bound;
+        assert(upper_bound > lower_bound);
+        for (usize_t i = upper_bound - lower_bound; i > 1; i--)
+          for (usize_t c = 0; c < configurations.size(); ++c) {
+            usize_t p = random_bounded(i, seeds[c]);
+            std::swap(configurations[c][lower_bound + i - 1], configurations[c][p + lower_bound]);
+          }
+      }
+      _seed += configurations.size() * num_draws * rapid_secret[0];
+    }
+
     rank_t rank_permutation(configuration_t &configuration) {
       using namespace core::helpers;
 
@@ -87,7 +115,24 @@ namespace sqsgen::core {
       }
     }
 
+    [[nodiscard]] std::uint64_t state() const { return _seed; }
+
+    void set_state(std::uint64_t state) { _seed = state; }
+
   private:
+    void shuffle_windows(configuration_t &configuration, std::uint64_t &seed) const {
+      for (auto &bound : _bounds) {
+        auto [lower_bound, upper_bound] = bound;
+        assert(upper_bound > lower_bound);
+        auto window_size = upper_bound - lower_bound;
+        for (usize_t i = window_size; i > 1; i--) {
+          usize_t p = random_bounded(i, seed);  // number in [0,i)
+          std::swap(configuration[lower_bound + i - 1],
+                    configuration[p + lower_bound]);  // swap the values at i-1 and p
+        }
+      }
+    }
+
     std::uint64_t _seed;
     std::vector<bounds_t<usize_t>> _bounds;
   };
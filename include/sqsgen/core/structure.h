@@ -6,6 +6,8 @@
 #define SQSGEN_CORE_STRUCTURE_H
 
 #include <Eigen/Dense>
+#include <mutex>
+#include <numeric>
 
 #include "sqsgen/core/atom.h"
 #include "sqsgen/core/helpers.h"
@@ -26,6 +28,80 @@ namespace sqsgen::core {
     Size shell;
   };
 
+  /*
+   * Compact pair list entry used by the optimization loop, eight bytes wide. Hence, it is limited
+   * to MAX_PACKED_SITES sites and MAX_PACKED_SHELLS shells
+   */
+  struct packed_pair {
+    std::uint32_t i;
+    std::uint32_t j : 24;
+    std::uint32_t shell : 8;
+  };
+
+  constexpr std::size_t MAX_PACKED_SITES = std::size_t{1} << 24;
+  constexpr std::size_t MAX_PACKED_SHELLS = std::size_t{1} << 8;
+
+  /*
+   * A pair list of a supercell, stored implicitly as the neighbors of each basis site of the
+   * primitive cell. Site (u, v, w, p) has index ((u * b + v) * c + w) * num_basis + p, its partners
+   * are found by shifting the cell by the offset of each template of p, wrapped around the shape
+   */
+  template <class Size>
+    requires std::is_integral_v<Size>
+  struct pair_template {
+    std::array<Size, 3> offset;
+    Size basis;
+    Size shell;
+    // the pair is its own image under inversion, and thus visited from both of its sites
+    bool symmetric;
+  };
+
+  template <class Size>
+    requires std::is_integral_v<Size>
+  struct periodic_pair_list {
+    std::array<Size, 3> shape;
+    Size num_basis;
+    // the templates of basis site p are templates[bounds[p]:bounds[p + 1]]
+    std::vector<Size> bounds;
+    std::vector<pair_template<Size>> templates;
+
+    [[nodiscard]] std::size_t num_sites() const {
+      return static_cast<std::size_t>(shape[0]) * shape[1] * shape[2] * num_basis;
+    }
+
+    [[nodiscard]] std::size_t num_pairs() const {
+      auto num_cells = static_cast<std::size_t>(shape[0]) * shape[1] * shape[2];
+      return helpers::fold_left(templates, std::size_t{0}, [&](auto sum, auto const &t) {
+        return sum + (t.symmetric ? num_cells / 2 : num_cells);
+      });
+    }
+
+    template <class Fn> void for_each(Fn &&fn) const {
+      const auto [a, b, c] = shape;
+      const Size row_length = c * num_basis;
+      // the innermost axis is walked as a whole for each template, thus the partner only has to be
+      // wrapped once per row
+      for (Size u = 0; u < a; ++u)
+        for (Size v = 0; v < b; ++v)
+          for (Size p = 0; p < num_basis; ++p) {
+            Size row = (u * b + v) * row_length + p;
+            for (auto t = bounds[p]; t < bounds[p + 1]; ++t) {
+              auto const &[offset, basis, shell, symmetric] = templates[t];
+              Size x = u + offset[0], y = v + offset[1];
+              if (x >= a) x -= a;
+              if (y >= b) y -= b;
+              Size i = row, j = (x * b + y) * row_length + offset[2] * num_basis + basis;
+              Size wrap = c - offset[2];
+              for (Size w = 0; w < wrap; ++w, i += num_basis, j += num_basis)
+                if (!symmetric || i < j) fn(i, j, shell);
+              j -= row_length;
+              for (Size w = wrap; w < c; ++w, i += num_basis, j += num_basis)
+                if (!symmetric || i < j) fn(i, j, shell);
+            }
+          }
+    }
+  };
+
   template <class T>
     requires std::is_arithmetic_v<T>
   class structure;
@@ -68,25 +144,199 @@ namespace sqsgen::core {
       return distances;
     }
 
+    template <class T> struct neighbor {
+      usize_t i;
+      usize_t j;
+      T distance;
+    };
+
+    /*
+     * Cell list neighbor search. Returns all pairs i < j (sorted) whose minimum image distance does
+     * not exceed cutoff, without ever materializing a N x N matrix. The bins are laid out along the
+     * fractional axes, their number is chosen such that a bin is at least cutoff wide perpendicular
+     * to its faces. Thus, also triclinic cells are handled, if a cell is thinner than the cutoff
+     * the search extends over as many periodic images as needed. If num_rows is given, only the
+     * first num_rows sites are searched, and all their partners j != i are returned
+     */
+    template <class T>
+    std::vector<neighbor<T>> neighbor_list(const lattice_t<T> &lattice,
+                                           const coords_t<T> &frac_coords, T cutoff,
+                                           std::optional<usize_t> num_rows = std::nullopt) {
+      using vec3_t = Eigen::Matrix<T, 1, 3>;
+      assert(frac_coords.cols() == 3);
+      const auto num_atoms = static_cast<usize_t>(frac_coords.rows());
+      std::array<vec3_t, 3> axes{vec3_t(lattice.row(0)), vec3_t(lattice.row(1)),
+                                 vec3_t(lattice.row(2))};
+      const T volume = std::abs(lattice.determinant());
+      // do not use (much) more bins than atoms, otherwise tiny cutoffs blow up the bin array
+      const auto max_bins = static_cast<long>(std::cbrt(static_cast<double>(num_atoms))) + 1;
+      std::array<long, 3> num_bins{}, reach{};
+      for (auto k = 0; k < 3; ++k) {
+        T width = volume / axes[(k + 1) % 3].cross(axes[(k + 2) % 3]).norm();
+        num_bins[k] = std::clamp(static_cast<long>(std::floor(width / cutoff)), 1L, max_bins);
+        reach[k] = static_cast<long>(std::ceil(cutoff * static_cast<T>(num_bins[k]) / width));
+      }
+
+      coords_t<T> wrapped = frac_coords.array() - frac_coords.array().floor();
+      const coords_t<T> cart_coords = wrapped * lattice;
+      const auto bin_of = [&](usize_t i) {
+        std::array<long, 3> b{};
+        for (auto k = 0; k < 3; ++k)
+          b[k] = std::min(static_cast<long>(wrapped(i, k) * static_cast<T>(num_bins[k])),
+                          num_bins[k] - 1);
+        return b;
+      };
+      const auto flat_index = [&](std::array<long, 3> const &b) {
+        return (b[0] * num_bins[1] + b[1]) * num_bins[2] + b[2];
+      };
+
+      // counting sort of the atoms into the bins
+      std::vector<usize_t> bin_start(num_bins[0] * num_bins[1] * num_bins[2] + 1, 0);
+      std::vector<long> atom_bin(num_atoms);
+      for (usize_t i = 0; i < num_atoms; ++i) {
+        atom_bin[i] = flat_index(bin_of(i));
+        ++bin_start[atom_bin[i] + 1];
+      }
+      std::partial_sum(bin_start.begin(), bin_start.end(), bin_start.begin());
+      std::vector<usize_t> binned(num_atoms);
+      {
+        auto next = bin_start;
+        for (usize_t i = 0; i < num_atoms; ++i) binned[next[atom_bin[i]]++] = i;
+      }
+
+      std::vector<neighbor<T>> neighbors;
+      std::vector<neighbor<T>> candidates;
+      const bool half = !num_rows.has_value();
+      for (usize_t i = 0; i < num_rows.value_or(num_atoms); ++i) {
+        candidates.clear();
+        auto b = bin_of(i);
+        vec3_t p1 = cart_coords.row(i);
+        for (auto u = b[0] - reach[0]; u <= b[0] + reach[0]; ++u)
+          for (auto v = b[1] - reach[1]; v <= b[1] + reach[1]; ++v)
+            for (auto w = b[2] - reach[2]; w <= b[2] + reach[2]; ++w) {
+              std::array<long, 3> image{}, bin{u, v, w};
+              for (auto k = 0; k < 3; ++k) {
+                image[k] = (bin[k] >= 0 ? bin[k] : bin[k] - num_bins[k] + 1) / num_bins[k];
+                bin[k] -= image[k] * num_bins[k];
+              }
+              vec3_t t = static_cast<T>(image[0]) * axes[0] + static_cast<T>(image[1]) * axes[1]
+                         + static_cast<T>(image[2]) * axes[2];
+              auto index = flat_index(bin);
+              for (auto n = bin_start[index]; n < bin_start[index + 1]; ++n) {
+                auto j = binned[n];
+                if (half ? j <= i : j == i) continue;
+                T distance = (cart_coords.row(j) + t - p1).norm();
+                if (distance <= cutoff) candidates.push_back({i, j, distance});
+              }
+            }
+        // a pair might be found via several images, keep the minimum image only
+        ranges::sort(candidates, [](auto const &a, auto const &b) {
+          return a.j < b.j || (a.j == b.j && a.distance < b.distance);
+        });
+        for (auto const &candidate : candidates)
+          if (neighbors.empty() || neighbors.back().i != i || neighbors.back().j != candidate.j)
+            neighbors.push_back(candidate);
+      }
+      return neighbors;
+    }
+
+    using cell_index_t = std::array<long, 3>;
+
+    inline usize_t flat_cell_index(cell_index_t const &cell,
+                                   std::array<std::size_t, 3> const &shape) {
+      return static_cast<usize_t>((cell[0] * shape[1] + cell[1]) * shape[2] + cell[2]);
+    }
+
+    /*
+     * Recovers the primitive cell of each site of a supercell whose first num_representatives sites
+     * are the basis of the primitive cell (see structure::supercell). The sites of all nested
+     * supercells are ordered translation major, thus the basis site of site s is
+     * s % num_representatives. Returns the cell of each site and the site of each (cell, basis)
+     * slot, or std::nullopt if the sites are not exact translates of the basis
+     */
+    template <class T>
+    std::optional<std::tuple<std::vector<cell_index_t>, std::vector<usize_t>>> supercell_cells(
+        const coords_t<T> &frac_coords, std::array<std::size_t, 3> const &shape,
+        usize_t num_representatives) {
+      const auto num_atoms = static_cast<usize_t>(frac_coords.rows());
+      const auto num_cells = static_cast<usize_t>(shape[0] * shape[1] * shape[2]);
+      if (num_cells <= 1 || num_representatives * num_cells != num_atoms) return std::nullopt;
+
+      std::vector<cell_index_t> cell_of(num_atoms);
+      std::vector<usize_t> site_of(num_atoms, num_atoms);
+      for (usize_t s = 0; s < num_atoms; ++s) {
+        auto basis = s % num_representatives;
+        for (auto k = 0; k < 3; ++k) {
+          auto n = static_cast<long>(shape[k]);
+          T offset = (frac_coords(s, k) - frac_coords(basis, k)) * static_cast<T>(n);
+          auto rounded = std::lround(offset);
+          if (std::abs(offset - static_cast<T>(rounded)) > T(1e-4)) return std::nullopt;
+          cell_of[s][k] = ((rounded % n) + n) % n;
+        }
+        auto &slot = site_of[flat_cell_index(cell_of[s], shape) * num_representatives + basis];
+        if (slot != num_atoms) return std::nullopt;
+        slot = s;
+      }
+      return std::make_tuple(cell_of, site_of);
+    }
+
+    /*
+     * Neighbor search for a supercell (see supercell_cells). Only the basis sites are searched, all
+     * other pairs are obtained by translating the basis pairs by each primitive cell of the
+     * supercell. Hence, equivalent pairs share exactly the same distance. Returns std::nullopt if
+     * the sites are not exact translates of the basis
+     */
+    template <class T> std::optional<std::vector<neighbor<T>>> periodic_neighbor_list(
+        const lattice_t<T> &lattice, const coords_t<T> &frac_coords,
+        std::array<std::size_t, 3> const &shape, usize_t num_representatives, T cutoff) {
+      auto cells = supercell_cells(frac_coords, shape, num_representatives);
+      if (!cells.has_value()) return std::nullopt;
+      auto const &[cell_of, site_of] = cells.value();
+
+      std::vector<neighbor<T>> neighbors;
+      for (auto &&[i, j, distance] : neighbor_list(lattice, frac_coords, cutoff,
+                                                   std::make_optional(num_representatives))) {
+        auto basis_j = j % num_representatives;
+        auto const &cell_j = cell_of[j];
+        helpers::for_each(
+            [&](long u, long v, long w) {
+              cell_index_t from{u, v, w};
+              cell_index_t to{(u + cell_j[0]) % static_cast<long>(shape[0]),
+                              (v + cell_j[1]) % static_cast<long>(shape[1]),
+                              (w + cell_j[2]) % static_cast<long>(shape[2])};
+              auto a = site_of[flat_cell_index(from, shape) * num_representatives + i];
+              auto b = site_of[flat_cell_index(to, shape) * num_representatives + basis_j];
+              // every pair is found once from each of its two sites
+              if (a < b) neighbors.push_back({a, b, distance});
+            },
+            static_cast<long>(shape[0]), static_cast<long>(shape[1]), static_cast<long>(shape[2]));
+      }
+      ranges::sort(neighbors, [](auto const &a, auto const &b) {
+        return a.i < b.i || (a.i == b.i && a.j < b.j);
+      });
+      return neighbors;
+    }
+
+    template <class T> int find_shell(T d, std::vector<T> const &dists, T atol, T rtol) {
+      auto is_close_tol = [=](T a, T b) { return helpers::is_close(a, b, atol, rtol); };
+      if (d < 0) throw std::out_of_range("Invalid distance matrix input");
+      if (is_close_tol(d, 0.0)) return 0;
+
+      for (auto i = 0; i < dists.size() - 1; i++) {
+        T lb{dists[i]}, up{dists[i + 1]};
+        if ((is_close_tol(d, lb) or d > lb) and (is_close_tol(d, up) or up > d)) {
+          return i + 1;
+        }
+      }
+      return static_cast<int>(dists.size());
+    }
+
     template <class T> shell_matrix_t shell_matrix(matrix_t<T> const &distance_matrix,
                                                    std::vector<T> const &dists, T atol, T rtol) {
       assert(distance_matrix.rows() == distance_matrix.cols());
       const auto num_atoms{distance_matrix.rows()};
 
-      auto is_close_tol = [=](T a, T b) { return helpers::is_close(a, b, atol, rtol); };
-
-      auto find_shell = [&](T d) {
-        if (d < 0) throw std::out_of_range("Invalid distance matrix input");
-        if (is_close_tol(d, 0.0)) return 0;
-
-        for (auto i = 0; i < dists.size() - 1; i++) {
-          T lb{dists[i]}, up{dists[i + 1]};
-          if ((is_close_tol(d, lb) or d > lb) and (is_close_tol(d, up) or up > d)) {
-            return i + 1;
-          }
-        }
-        return static_cast<int>(dists.size());
-      };
+      auto find_shell = [&](T d) { return detail::find_shell(d, dists, atol, rtol); };
       shell_matrix_t shells = matrix_t<usize_t>(num_atoms, num_atoms);
       for (auto i = 0; i < num_atoms; i++) {
         for (auto j = i + 1; j < num_atoms; j++) {
@@ -133,12 +383,12 @@ namespace sqsgen::core {
       return static_cast<usize_t>(helpers::sorted_vector<specie_t>(configuration).size());
     }
 
-    template <class T> cube_t<T> compute_prefactors(shell_matrix_t const &shell_matrix,
+    // neighbors maps a shell to number of (ordered) pairs i-j in this shell
+    template <class T> cube_t<T> compute_prefactors(counter<usize_t> neighbors,
                                                     shell_weights_t<T> const &weights,
                                                     configuration_t const &configuration) {
       using namespace helpers;
       if (weights.empty()) throw std::out_of_range("no coordination shells selected");
-      auto neighbors = count(shell_matrix.reshaped());
       for (const auto &[shell, count] : neighbors) {
         auto atoms_per_shell{static_cast<T>(count) / static_cast<T>(configuration.size())};
         if (atoms_per_shell < 1)
@@ -190,69 +440,149 @@ namespace sqsgen::core {
       }
       return prefactors;
     }
+
+    template <class T> cube_t<T> compute_prefactors(shell_matrix_t const &shell_matrix,
+                                                    shell_weights_t<T> const &weights,
+                                                    configuration_t const &configuration) {
+      return compute_prefactors<T>(helpers::count(shell_matrix.reshaped()), weights,
+                                   configuration);
+    }
+
+    // each pair i < j accounts for the two neighbors i-j and j-i
+    template <class T, class Size>
+    cube_t<T> compute_prefactors(std::vector<atom_pair<Size>> const &pairs,
+                                 shell_weights_t<T> const &weights,
+                                 configuration_t const &configuration) {
+      counter<usize_t> neighbors;
+      for (auto const &pair : pairs) neighbors[static_cast<usize_t>(pair.shell)] += 2;
+      return compute_prefactors<T>(neighbors, weights, configuration);
+    }
+  }  // namespace detail
+
+  namespace detail {
+    /*
+     * Calls fn(row) with the minimum image distances (see distance_matrix) of each site i to all
+     * other sites. Only the translation representatives of a supercell are visited, since all other
+     * rows contain the same distances. The rows are processed in parallel, fn must be thread safe.
+     * At most one row per thread is kept in memory
+     */
+    template <class T, class Fn>
+    void for_each_distance_row(structure<T> const &structure, Fn &&fn) {
+      const coords_t<T> cart_coords = structure.frac_coords * structure.lattice;
+      const auto num_atoms = static_cast<long>(structure.size());
+      const auto num_rows = static_cast<long>(structure.num_representatives());
+      std::array<Eigen::Matrix<T, 1, 3>, 27> translations;
+      auto index{0};
+      helpers::for_each(
+          [&](auto u, auto v, auto w) {
+            translations[index++] = static_cast<T>(u) * structure.lattice.row(0)
+                                    + static_cast<T>(v) * structure.lattice.row(1)
+                                    + static_cast<T>(w) * structure.lattice.row(2);
+          },
+          std::array{-1, 0, 1}, std::array{-1, 0, 1}, std::array{-1, 0, 1});
+#pragma omp parallel for schedule(dynamic) if (num_rows > 16)
+      for (long i = 0; i < num_rows; ++i) {
+        std::vector<T> row(num_atoms, std::numeric_limits<T>::max());
+        Eigen::Matrix<T, 1, 3> p1 = cart_coords.row(i);
+        for (long j = 0; j < num_atoms; ++j)
+          for (auto const &t : translations)
+            row[j] = std::min(row[j], T((p1 - (t + cart_coords.row(j))).norm()));
+        fn(std::move(row));
+      }
+    }
+
+    // merges runs of close values of a sorted range. A shell is represented by its largest
+    // distance, such that all distances of the shell lie within its radius
+    template <class T>
+    std::vector<T> reduce_distances(std::vector<T> const &sorted, T atol, T rtol) {
+      std::vector<T> reduced{T(0)};
+      for (auto dist : sorted) {
+        if (helpers::is_close(reduced.back(), dist, atol, rtol)) {
+          if (reduced.size() > 1) reduced.back() = std::max(reduced.back(), dist);
+        } else
+          reduced.push_back(dist);
+      }
+      return reduced;
+    }
+
+    template <class T> std::vector<T> merge_distances(std::vector<T> const &a,
+                                                      std::vector<T> const &b, T atol, T rtol) {
+      std::vector<T> merged;
+      merged.reserve(a.size() + b.size());
+      std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged));
+      return reduce_distances(merged, atol, rtol);
+    }
   }  // namespace detail
 
   template <class T> std::vector<T> distances_naive(structure<T> &&structure,
                                                     T atol = std::numeric_limits<T>::epsilon(),
                                                     T rtol = 1e-9) {
-    helpers::sorted_vector<T> dists(structure.distance_matrix().reshaped());
-    auto reduced = helpers::fold_left(dists, std::vector<T>{T(0)}, [&](auto &&vec, auto dist) {
-      if (helpers::is_close(vec.back(), dist, atol, rtol))
-        vec[vec.size() - 1] = 0.5 * (dist + vec.back());
-      else
-        vec.push_back(dist);
-      return vec;
+    std::vector<T> shells{T(0)};
+    std::mutex mutex;
+    sqsgen::core::detail::for_each_distance_row(structure, [&](std::vector<T> &&row) {
+      std::sort(row.begin(), row.end());
+      auto reduced = sqsgen::core::detail::reduce_distances(row, atol, rtol);
+      std::scoped_lock lock{mutex};
+      shells = sqsgen::core::detail::merge_distances(shells, reduced, atol, rtol);
     });
-    return reduced;
+    return shells;
   }
 
   template <class T>
   std::vector<T> distances_histogram(structure<T> &&structure, T bin_width, T peak_isolation) {
-    auto distances = helpers::as<std::vector>{}(
-        structure.distance_matrix().reshaped()
-        | views::filter([](auto dist) { return dist > 0.0 && !helpers::is_close<T>(dist, 0.0); }));
-    std::sort(distances.begin(), distances.end());
-    T min_dist{distances.front()}, max_dist{distances.back()};
+    const auto is_distance = [](T dist) { return dist > 0.0 && !helpers::is_close<T>(dist, 0.0); };
+    // first pass: the range of distances determines the bins
+    T min_dist{std::numeric_limits<T>::max()}, max_dist{std::numeric_limits<T>::lowest()};
+    std::mutex mutex;
+    sqsgen::core::detail::for_each_distance_row(structure, [&](std::vector<T> &&row) {
+      auto [row_min, row_max] = std::make_pair(std::numeric_limits<T>::max(),
+                                               std::numeric_limits<T>::lowest());
+      for (auto dist : row | views::filter(is_distance)) {
+        row_min = std::min(row_min, dist);
+        row_max = std::max(row_max, dist);
+      }
+      std::scoped_lock lock{mutex};
+      min_dist = std::min(min_dist, row_min);
+      max_dist = std::max(max_dist, row_max);
+    });
+    if (min_dist > max_dist)
+      throw std::invalid_argument("The structure does not contain any interatomic distances");
 
     auto num_edges{static_cast<std::size_t>((max_dist - min_dist) / bin_width) + 2};
-
-    // for some reason as<std::vector> does not work here
-    auto edges = std::vector<T>(num_edges);
-    for (std::size_t i = 0; i < num_edges; i++) edges[i] = min_dist + static_cast<T>(i) * bin_width;
-
-    if (edges.size() < 10)
+    if (num_edges < 10)
       throw std::invalid_argument(
           "Not enough edges to create a histogram, please increase the bin width");
-    auto freqs = std::map<usize_t, std::vector<T>>{{0, {}}};
-    usize_t index{0}, bin{0};
-    while (index < distances.size() && bin < num_edges - 1) {
-      T lower{edges[bin]}, upper{edges[bin + 1]}, value{distances[index]};
-      if (lower <= value && value < upper) {
-        freqs[bin].push_back(value);
-        ++index;
-      } else
-        freqs[++bin] = std::vector<T>{};
-    }
-    // make sure our histogramm contains the same number of distances as the corresponding input
-    // vector
-    assert(helpers::fold_left(
-               views::elements<1>(freqs) | views::transform([&](auto v) { return v.size(); }), 0,
-               std::plus{})
-           == distances.size());
-    const auto get_freq
-        = [&](auto i) { return freqs.contains(i) ? freqs.at(i) : std::vector<T>{}; };
-    assert(freqs.size() == num_edges - 1);
-    std::vector<T> shells;
-    for (auto i = 0; i <= num_edges; i++) {
-      auto prev{get_freq(i - 1)}, f{get_freq(i)}, next{get_freq(i + 1)};
-      auto threshold = static_cast<std::size_t>((1.0 - peak_isolation) * static_cast<T>(f.size()));
-      if (threshold > prev.size() && threshold > next.size()) {
-        assert(freqs.size() > 0);
-        shells.push_back(*std::max_element(f.begin(), f.end()));
+
+    // second pass: only the number of distances and the largest distance per bin are needed
+    auto num_bins{num_edges - 1};
+    std::vector<std::size_t> counts(num_bins, 0);
+    std::vector<T> maxima(num_bins, std::numeric_limits<T>::lowest());
+    sqsgen::core::detail::for_each_distance_row(structure, [&](std::vector<T> &&row) {
+      std::vector<std::size_t> row_counts(num_bins, 0);
+      std::vector<T> row_maxima(num_bins, std::numeric_limits<T>::lowest());
+      for (auto dist : row | views::filter(is_distance)) {
+        auto bin = std::min(static_cast<std::size_t>((dist - min_dist) / bin_width), num_bins - 1);
+        ++row_counts[bin];
+        row_maxima[bin] = std::max(row_maxima[bin], dist);
       }
+      std::scoped_lock lock{mutex};
+      for (std::size_t bin = 0; bin < num_bins; ++bin) {
+        counts[bin] += row_counts[bin];
+        maxima[bin] = std::max(maxima[bin], row_maxima[bin]);
+      }
+    });
+
+    const auto get_count = [&](long bin) {
+      return bin >= 0 && bin < static_cast<long>(num_bins) ? counts[bin] : std::size_t{0};
+    };
+    std::vector<T> shells;
+    for (long i = 0; i <= static_cast<long>(num_edges); i++) {
+      auto prev{get_count(i - 1)}, f{get_count(i)}, next{get_count(i + 1)};
+      auto threshold = static_cast<std::size_t>((1.0 - peak_isolation) * static_cast<T>(f));
+      if (threshold > prev && threshold > next) shells.push_back(maxima[i]);
     }
 
-    if (shells.front() != 0.0 && !helpers::is_close<T>(shells.front(), 0.0))
+    if (shells.empty() || (shells.front() != 0.0 && !helpers::is_close<T>(shells.front(), 0.0)))
       shells.insert(shells.begin(), 0.0);
     return shells;
   }
@@ -260,8 +590,8 @@ namespace sqsgen::core {
   template <class T> cube_t<T> compute_prefactors(structure<T> &&structure,
                                                   std::vector<T> const &shell_radii,
                                                   shell_weights_t<T> const &weights) {
-    return sqsgen::core::detail::compute_prefactors<T>(structure.shell_matrix(shell_radii), weights,
-                                                       structure.species);
+    auto pairs = std::get<0>(structure.pairs(shell_radii, weights, false));
+    return sqsgen::core::detail::compute_prefactors<T>(pairs, weights, structure.species);
   }
 
   template <class T>
@@ -276,6 +606,8 @@ namespace sqsgen::core {
     configuration_t species;
     std::array<bool, 3> pbc = {true, true, true};
     usize_t num_species;
+    // number of primitive cells along each axis if the structure was created by supercell()
+    std::array<std::size_t, 3> supercell_shape = {1, 1, 1};
 
     structure() = default;
 
@@ -362,11 +694,23 @@ namespace sqsgen::core {
           },
           a, b, c);
 
-      return structure(lattice * scale, supercell_coords, supercell_species, pbc);
+      structure result(lattice * scale, supercell_coords, supercell_species, pbc);
+      result.supercell_shape
+          = {supercell_shape[0] * a, supercell_shape[1] * b, supercell_shape[2] * c};
+      return result;
     }
 
     [[nodiscard]] std::size_t size() const { return species.size(); }
 
+    /*
+     * The sites of a supercell are ordered by translation, hence the first size() / (a * b * c)
+     * sites represent all sites up to a lattice translation of the primitive cell
+     */
+    [[nodiscard]] std::size_t num_representatives() const {
+      auto num_cells = supercell_shape[0] * supercell_shape[1] * supercell_shape[2];
+      return num_cells > 0 && size() % num_cells == 0 ? size() / num_cells : size();
+    }
+
     auto sites() const {
       return ranges::iota_view(static_cast<usize_t>(0), static_cast<usize_t>(size()))
              | views::transform([&](auto i) {
@@ -377,7 +721,7 @@ namespace sqsgen::core {
 
     template <class Fn> auto sorted_with_indices(Fn &&fn) const {
       auto s = helpers::as<std::vector>{}(sites());
-      std::sort(s.begin(), s.end(), std::forward<Fn>(fn));
+      std::stable_sort(s.begin(), s.end(), std::forward<Fn>(fn));
       return std::make_tuple(
           structure(lattice, s),
           helpers::as<std::vector>{}(s | views::transform([](auto site) { return site.index; })));
@@ -400,7 +744,9 @@ namespace sqsgen::core {
 
     structure with_species(configuration_t const &conf) {
       if (conf.size() != size()) throw std::invalid_argument("Species size mismatch");
-      return structure{lattice, frac_coords, conf, pbc};
+      structure result{lattice, frac_coords, conf, pbc};
+      result.supercell_shape = supercell_shape;
+      return result;
     }
 
     std::vector<structure> apply_composition_and_decompose(
@@ -438,6 +784,28 @@ namespace sqsgen::core {
       using namespace helpers;
       auto [shell_map, reverse_map] = make_index_mapping<Size>(weights | views::elements<0>);
       std::vector<atom_pair<Size>> pairs;
+      // all weighted shells lie within a finite cutoff, hence a neighbor search suffices
+      auto max_shell = weights.empty() ? radii.size() : ranges::max(weights | views::elements<0>);
+      if (max_shell < radii.size()) {
+        // the slightly enlarged cutoff only admits pairs which are dropped by the shell lookup
+        T radius{radii[max_shell]};
+        T cutoff{radius * T(1.000001) + atol + rtol * std::abs(radius)};
+        // a supercell only needs a search around the sites of its primitive cell
+        auto neighbors = sqsgen::core::detail::periodic_neighbor_list(
+            lattice, frac_coords, supercell_shape, static_cast<usize_t>(num_representatives()),
+            cutoff);
+        if (!neighbors.has_value())
+          neighbors = sqsgen::core::detail::neighbor_list(lattice, frac_coords, cutoff);
+        for (auto &&[i, j, distance] : neighbors.value()) {
+          auto shell = static_cast<usize_t>(sqsgen::core::detail::find_shell(distance, radii, atol,
+                                                                             rtol));
+          if (!weights.contains(shell)) continue;
+          pairs.push_back({static_cast<Size>(i), static_cast<Size>(j),
+                           static_cast<Size>(pack ? shell_map[shell] : shell)});
+        }
+        pairs.shrink_to_fit();
+        return std::make_tuple(pairs, shell_map, reverse_map);
+      }
       pairs.reserve(size() * size() / 2);
       auto sm = shell_matrix(radii, atol, rtol);
       for (Size i = 0; i < size(); ++i) {
@@ -450,6 +818,72 @@ namespace sqsgen::core {
       return std::make_tuple(pairs, shell_map, reverse_map);
     }
 
+    /*
+     * Implicit counterpart of pairs, available only for supercells whose sites are laid out as
+     * created by supercell(), and if all weighted shells lie within a finite cutoff. Every pair
+     * (i, j) is visited exactly once, however not necessarily with i < j
+     */
+    template <class Size = usize_t>
+      requires std::is_integral_v<Size>
+    std::optional<periodic_pair_list<Size>> periodic_pairs(
+        std::vector<T> const &radii, shell_weights_t<T> const &weights, bool pack = true,
+        T atol = std::numeric_limits<T>::epsilon(), T rtol = 1.0e-9) const {
+      using namespace helpers;
+      using cell_index_t = sqsgen::core::detail::cell_index_t;
+      auto max_shell = weights.empty() ? radii.size() : ranges::max(weights | views::elements<0>);
+      if (max_shell >= radii.size()) return std::nullopt;
+      auto num_basis = static_cast<usize_t>(num_representatives());
+      auto cells = sqsgen::core::detail::supercell_cells(frac_coords, supercell_shape, num_basis);
+      if (!cells.has_value()) return std::nullopt;
+      auto const &[cell_of, site_of] = cells.value();
+      for (usize_t s = 0; s < site_of.size(); ++s)
+        if (site_of[s] != s) return std::nullopt;
+
+      auto [shell_map, _] = make_index_mapping<Size>(weights | views::elements<0>);
+      T radius{radii[max_shell]};
+      T cutoff{radius * T(1.000001) + atol + rtol * std::abs(radius)};
+      const auto shape = supercell_shape;
+      const auto inverse = [&](cell_index_t const &cell) -> cell_index_t {
+        cell_index_t result;
+        for (auto k = 0; k < 3; ++k) {
+          auto n = static_cast<long>(shape[k]);
+          result[k] = (n - cell[k]) % n;
+        }
+        return result;
+      };
+
+      periodic_pair_list<Size> list{{static_cast<Size>(shape[0]), static_cast<Size>(shape[1]),
+                                     static_cast<Size>(shape[2])},
+                                    static_cast<Size>(num_basis),
+                                    {0},
+                                    {}};
+      // the neighbors are sorted by i, and thus grouped by basis site. A pair (p, q, d) is also
+      // found as (q, p, -d), only the lexicographically smaller one is kept
+      auto neighbors = sqsgen::core::detail::neighbor_list(lattice, frac_coords, cutoff,
+                                                           std::make_optional(num_basis));
+      auto current = neighbors.begin();
+      for (usize_t p = 0; p < num_basis; ++p) {
+        for (; current != neighbors.end() && current->i == p; ++current) {
+          auto j = current->j;
+          auto shell = static_cast<usize_t>(
+              sqsgen::core::detail::find_shell(current->distance, radii, atol, rtol));
+          if (!weights.contains(shell)) continue;
+          auto q = j % num_basis;
+          auto const &offset = cell_of[j];
+          auto reverse = inverse(offset);
+          if (q < p || (q == p && reverse < offset)) continue;
+          list.templates.push_back(
+              {{static_cast<Size>(offset[0]), static_cast<Size>(offset[1]),
+                static_cast<Size>(offset[2])},
+               static_cast<Size>(q),
+               static_cast<Size>(pack ? shell_map[shell] : shell),
+               q == p && reverse == offset});
+        }
+        list.bounds.push_back(static_cast<Size>(list.templates.size()));
+      }
+      return list;
+    }
+
     [[nodiscard]] configuration_t packed_species() const {
       auto [map, _] = helpers::make_index_mapping<specie_t>(species);
       return helpers::as<std::vector>{}(species | views::transform([&](auto z) { return map[z]; }));
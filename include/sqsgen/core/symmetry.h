@@ -0,0 +1,212 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_CORE_SYMMETRY_H
+#define SQSGEN_CORE_SYMMETRY_H
+
+#include <compare>
+
+#include "absl/container/flat_hash_map.h"
+#include "sqsgen/core/config.h"
+#include "sqsgen/core/optimization_config.h"
+#include "sqsgen/core/structure.h"
+#include "sqsgen/types.h"
+
+namespace sqsgen::core {
+
+  namespace detail {
+
+    using site_key_t = std::array<long, 3>;
+
+    // fractional coordinates are wrapped along periodic axes and snapped to a grid of spacing tol
+    template <class T>
+    site_key_t site_key(Eigen::Matrix<T, 1, 3> const &x, std::array<bool, 3> const &pbc, T tol) {
+      auto grid = std::lround(T(1) / tol);
+      site_key_t key;
+      for (auto k = 0; k < 3; ++k) {
+        auto snapped = std::lround(x(k) / tol);
+        key[k] = pbc[k] ? (snapped % grid + grid) % grid : snapped;
+      }
+      return key;
+    }
+
+    // integer matrices with entries in {-1, 0, 1} which leave the metric of the lattice invariant
+    template <class T> std::vector<lattice_t<T>> point_operations(lattice_t<T> const &lattice,
+                                                                  bool translations_only, T tol) {
+      if (translations_only) return {lattice_t<T>::Identity()};
+      lattice_t<T> metric = lattice * lattice.transpose();
+      T scale = metric.cwiseAbs().maxCoeff();
+      std::vector<lattice_t<T>> operations;
+      lattice_t<T> r;
+      for (auto code = 0; code < 19683; ++code) {
+        auto c = code;
+        for (auto k = 0; k < 9; ++k, c /= 3) r(k / 3, k % 3) = static_cast<T>(c % 3 - 1);
+        if (std::abs(std::abs(r.determinant()) - 1) > tol) continue;
+        if ((r * metric * r.transpose() - metric).cwiseAbs().maxCoeff() > tol * scale) continue;
+        operations.push_back(r);
+      }
+      return operations;
+    }
+  }  // namespace detail
+
+  /*
+   * Permutations of the sites of a structure which map it onto itself. A permutation p moves site
+   * i to site p[i], and only ever maps sites with the same label onto each other. If
+   * translations_only is set only translations are considered, otherwise also the point
+   * operations whose matrix in fractional coordinates has entries in {-1, 0, 1}
+   */
+  template <class T> std::vector<std::vector<usize_t>> site_permutations(
+      structure<T> const &structure, std::vector<usize_t> const &labels, bool translations_only,
+      T tol = T(1.0e-5)) {
+    using vec3_t = Eigen::Matrix<T, 1, 3>;
+    namespace detail = sqsgen::core::detail;
+    auto num_sites = structure.size();
+    absl::flat_hash_map<detail::site_key_t, usize_t> lookup;
+    for (usize_t i = 0; i < num_sites; ++i)
+      lookup.emplace(detail::site_key<T>(structure.frac_coords.row(i), structure.pbc, tol), i);
+
+    // the translations are anchored at a site of the rarest label
+    absl::flat_hash_map<usize_t, usize_t> label_count;
+    for (auto label : labels) ++label_count[label];
+    usize_t anchor{0};
+    for (usize_t i = 0; i < num_sites; ++i)
+      if (label_count[labels[i]] < label_count[labels[anchor]]) anchor = i;
+
+    std::vector<std::vector<usize_t>> permutations;
+    std::vector<usize_t> permutation(num_sites);
+    for (auto &&r : detail::point_operations(structure.lattice, translations_only, tol)) {
+      vec3_t rotated_anchor = structure.frac_coords.row(anchor) * r;
+      for (usize_t j = 0; j < num_sites; ++j) {
+        if (labels[j] != labels[anchor]) continue;
+        vec3_t translation = structure.frac_coords.row(j) - rotated_anchor;
+        bool valid{true};
+        for (usize_t i = 0; i < num_sites && valid; ++i) {
+          vec3_t image = structure.frac_coords.row(i) * r + translation;
+          auto it = lookup.find(detail::site_key<T>(image, structure.pbc, tol));
+          valid = it != lookup.end() && labels[it->second] == labels[i];
+          if (valid) permutation[i] = it->second;
+        }
+        if (valid) permutations.push_back(permutation);
+      }
+    }
+    return permutations;
+  }
+
+  /*
+   * Maps configurations onto the lexicographically smallest image under a group of site
+   * permutations, such that symmetrically equivalent results share the same representative. The
+   * permutations of a group element act on all sublattices at once
+   */
+  class canonicalizer {
+    // _sources[g][sigma][j] is the site of sublattice sigma which element g moves onto site j
+    std::vector<std::vector<std::vector<usize_t>>> _sources;
+
+  public:
+    canonicalizer() = default;
+
+    // permutations[g][sigma] permutes the sites of sublattice sigma
+    explicit canonicalizer(std::vector<std::vector<std::vector<usize_t>>> const &permutations) {
+      _sources.reserve(permutations.size());
+      for (auto &&group_element : permutations) {
+        std::vector<std::vector<usize_t>> sources;
+        for (auto &&permutation : group_element) {
+          std::vector<usize_t> source(permutation.size());
+          for (usize_t i = 0; i < permutation.size(); ++i) source[permutation[i]] = i;
+          sources.push_back(std::move(source));
+        }
+        _sources.push_back(std::move(sources));
+      }
+    }
+
+    [[nodiscard]] bool empty() const { return _sources.empty(); }
+
+    [[nodiscard]] std::size_t size() const { return _sources.size(); }
+
+    void canonicalize(std::vector<configuration_t> &configurations) const {
+      if (empty()) return;
+      auto best{configurations};
+      for (auto &&sources : _sources) {
+        // images are compared site by site, most of them differ from the best one early on
+        auto compare = std::strong_ordering::equal;
+        for (auto sigma = 0; sigma < configurations.size() && compare == 0; ++sigma) {
+          auto const &source = sources[sigma];
+          auto const &configuration = configurations[sigma];
+          for (usize_t j = 0; j < source.size() && compare == 0; ++j)
+            compare = configuration[source[j]] <=> best[sigma][j];
+        }
+        if (compare >= 0) continue;
+        for (auto sigma = 0; sigma < configurations.size(); ++sigma)
+          for (usize_t j = 0; j < sources[sigma].size(); ++j)
+            best[sigma][j] = configurations[sigma][sources[sigma][j]];
+      }
+      configurations = std::move(best);
+    }
+
+    void canonicalize(configuration_t &configuration) const {
+      if (empty()) return;
+      std::vector<configuration_t> configurations{std::move(configuration)};
+      canonicalize(configurations);
+      configuration = std::move(configurations.front());
+    }
+
+    /*
+     * The site permutations of the whole supercell, restricted to the sorted sites of each
+     * sublattice. Sites of different shuffling windows, and sites which never change but hold
+     * different species, are never mapped onto each other
+     */
+    template <class T, SublatticeMode Mode>
+    static canonicalizer from_config(configuration<T> const &config,
+                                     std::vector<optimization_config<T, Mode>> const &opt_configs) {
+      if (config.deduplication == DEDUPLICATION_MODE_EXACT) return {};
+      auto full = config.structure.structure().apply_composition(config.composition);
+      // maps the sorted sites of each sublattice to the sites of the full supercell
+      std::vector<std::vector<usize_t>> full_index;
+      for (auto sigma = 0; sigma < opt_configs.size(); ++sigma) {
+        auto const &sort_order = opt_configs[sigma].sort_order;
+        if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+          full_index.push_back(sort_order);
+        else {
+          auto sites = helpers::as<std::vector>{}(config.composition[sigma].sites);
+          full_index.push_back(helpers::as<std::vector>{}(
+              sort_order | views::transform([&](auto k) { return sites[k]; })));
+        }
+      }
+      usize_t num_windows{0};
+      for (auto &&c : opt_configs) num_windows += c.bounds.size();
+      std::vector<usize_t> labels(full.size());
+      for (usize_t i = 0; i < full.size(); ++i) labels[i] = num_windows + full.species[i];
+      usize_t window{0};
+      for (auto sigma = 0; sigma < opt_configs.size(); ++sigma)
+        for (auto &&[lower, upper] : opt_configs[sigma].bounds) {
+          for (auto k = lower; k < upper; ++k) labels[full_index[sigma][k]] = window;
+          ++window;
+        }
+
+      std::vector<std::vector<usize_t>> sorted_index;
+      for (auto &&indices : full_index) {
+        std::vector<usize_t> inverse(full.size());
+        for (usize_t k = 0; k < indices.size(); ++k) inverse[indices[k]] = k;
+        sorted_index.push_back(std::move(inverse));
+      }
+      std::vector<std::vector<std::vector<usize_t>>> permutations;
+      for (auto &&permutation : site_permutations(
+               full, labels, config.deduplication == DEDUPLICATION_MODE_TRANSLATIONS)) {
+        std::vector<std::vector<usize_t>> group_element;
+        for (auto sigma = 0; sigma < full_index.size(); ++sigma)
+          group_element.push_back(helpers::as<std::vector>{}(
+              full_index[sigma]
+              | views::transform([&](auto i) { return sorted_index[sigma][permutation[i]]; })));
+        permutations.push_back(std::move(group_element));
+      }
+      // operations which only differ on sites that never change collapse into the same element
+      ranges::sort(permutations);
+      permutations.erase(std::unique(permutations.begin(), permutations.end()),
+                         permutations.end());
+      return canonicalizer{permutations};
+    }
+  };
+
+}  // namespace sqsgen::core
+
+#endif  // SQSGEN_CORE_SYMMETRY_H
@@ -0,0 +1,73 @@
+//
+// Created by Dominik Gehringer on 21.04.25.
+//
+
+#ifndef SQSGEN_IO_CHECKPOINT_H
+#define SQSGEN_IO_CHECKPOINT_H
+
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include "sqsgen/core/checkpoint.h"
+#include "sqsgen/io/json.h"
+#include "sqsgen/log.h"
+
+namespace sqsgen::io {
+
+  // each rank of an MPI run writes a separate checkpoint file
+  inline std::filesystem::path checkpoint_path(std::string const& path, int rank, int num_ranks) {
+    if (num_ranks > 1) return format_string("%s.%i", path, rank);
+    return path;
+  }
+
+  /*
+   * The checkpoint is serialized into a temporary file first, which then replaces the checkpoint
+   * file. Thus, a job which is killed while writing never leaves a corrupted checkpoint behind
+   */
+  template <class T, SublatticeMode Mode>
+  void write_checkpoint(std::filesystem::path const& path,
+                        core::sqs_checkpoint<T, Mode> const& checkpoint) {
+    nlohmann::json j = checkpoint;
+    auto bytes = nlohmann::json::to_msgpack(j);
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+      std::ofstream out(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!out.good())
+        throw std::runtime_error(
+            format_string("Cannot open checkpoint file \"%s\"", temporary.string()));
+      out.write(reinterpret_cast<const char*>(bytes.data()),
+                static_cast<std::streamsize>(bytes.size()));
+      if (!out.good())
+        throw std::runtime_error(
+            format_string("Failed to write checkpoint file \"%s\"", temporary.string()));
+    }
+    std::filesystem::rename(temporary, path);
+  }
+
+  inline core::sqs_checkpoint_t read_checkpoint(std::filesystem::path const& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.good())
+      throw std::runtime_error(format_string("Cannot open checkpoint file \"%s\"", path.string()));
+    auto j = nlohmann::json::from_msgpack(in);
+    if (!j.contains("prec") || !j.contains("config") || !j.at("config").contains("sublattice_mode"))
+      throw std::invalid_argument(
+          format_string("\"%s\" is not a valid sqsgen checkpoint", path.string()));
+    auto prec = j.at("prec").get<Prec>();
+    auto mode = j.at("config").at("sublattice_mode").get<SublatticeMode>();
+    if (prec == PREC_SINGLE && mode == SUBLATTICE_MODE_INTERACT)
+      return j.get<core::sqs_checkpoint<float, SUBLATTICE_MODE_INTERACT>>();
+    if (prec == PREC_SINGLE && mode == SUBLATTICE_MODE_SPLIT)
+      return j.get<core::sqs_checkpoint<float, SUBLATTICE_MODE_SPLIT>>();
+    if (prec == PREC_DOUBLE && mode == SUBLATTICE_MODE_INTERACT)
+      return j.get<core::sqs_checkpoint<double, SUBLATTICE_MODE_INTERACT>>();
+    if (prec == PREC_DOUBLE && mode == SUBLATTICE_MODE_SPLIT)
+      return j.get<core::sqs_checkpoint<double, SUBLATTICE_MODE_SPLIT>>();
+    throw std::invalid_argument(
+        format_string("\"%s\" contains an invalid precision or sublattice mode", path.string()));
+  }
+
+}  // namespace sqsgen::io
+
+#endif  // SQSGEN_IO_CHECKPOINT_H
@@ -9,6 +9,7 @@
 
 #include "arrays.h"
 #include "shared.h"
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/core/structure.h"
 #include "sqsgen/io/config/shared.h"
@@ -152,13 +153,16 @@ namespace sqsgen::io::config {
     }
   }  // namespace detail
 
+  // the neighbors are counted on the pair lists of geometry, if it is given
   template <string_literal key, class T, class Document>
   parse_result<detail::array_t<T>> parse_prefactors(
       Document const& document, SublatticeMode mode, core::structure<T>&& structure,
       std::vector<sublattice> const& composition, stl_matrix_t<T> const& shell_radii,
-      std::vector<shell_weights_t<T>> const& shell_weights) {
+      std::vector<shell_weights_t<T>> const& shell_weights,
+      core::geometry_cache<T>* geometry = nullptr) {
     return detail::parse_array_with_default<key, T>(
-        [](auto&& st, auto&& w, auto&& radii) -> parse_result<cube_t<T>> {
+        [&](auto&& st, auto&& w, auto&& radii) -> parse_result<cube_t<T>> {
+          if (geometry) return core::compute_prefactors(st, radii, w, *geometry);
           return core::compute_prefactors(std::forward<core::structure<T>>(st), radii, w);
         },
         document, mode, std::forward<core::structure<T>>(structure), composition, shell_weights,
@@ -29,12 +29,33 @@ namespace sqsgen::io::config {
                                                 "thread_config",
                                                 "keep",
                                                 "max_results_per_objective",
+                                                "shared_memory",
+                                                "checkpoint",
+                                                "checkpoint_interval",
+                                                "geometry_cache",
+                                                "spill",
+                                                "spill_limit",
+                                                "max_time",
+                                                "objective_threshold",
+                                                "max_stagnation",
+                                                "compact_results",
+                                                "deduplication",
+                                                "variants",
+                                                "sweep",
                                                 "atol",
                                                 "rtol",
                                                 "prec",
                                                 "bin_width",
                                                 "peak_isolation"};
 
+  static constexpr auto VARIANT_KEYS
+      = std::array{"shell_weights", "prefactors", "pair_weights", "target_objective"};
+
+  static constexpr auto SWEEP_KEYS = std::array{"composition"};
+
+  static constexpr auto RESCORE_KEYS = std::array{"shell_weights", "prefactors", "pair_weights",
+                                                  "target_objective", "thread_config"};
+
   static constexpr iterations_t iterations_default = 500000;
   static constexpr iterations_t chunk_size_default = 100000;
 
@@ -189,10 +210,252 @@ namespace sqsgen::io::config {
       return {std::nullopt};
   }
 
+  template <string_literal key, class Document>
+  parse_result<bool> parse_shared_memory(Document const& doc) {
+    return get_optional<key, bool>(doc).value_or(parse_result<bool>{false});
+  }
+
+  template <string_literal key, class Document>
+  parse_result<bool> parse_compact_results(Document const& doc) {
+    return get_optional<key, bool>(doc).value_or(parse_result<bool>{false});
+  }
+
+  template <string_literal key, class Document>
+  parse_result<DeduplicationMode> parse_deduplication(Document const& doc) {
+    return get_optional<key, DeduplicationMode>(doc)
+        .value_or(parse_result<DeduplicationMode>{DEDUPLICATION_MODE_EXACT})
+        .and_then([&](auto&& mode) -> parse_result<DeduplicationMode> {
+          if (mode == DEDUPLICATION_MODE_INVALID)
+            return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                "Invalid deduplication mode. Must be either \"exact\", \"translations\" or "
+                "\"symmetry\"");
+          return mode;
+        });
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::optional<std::string>> parse_checkpoint(Document const& doc) {
+    if (std::optional<parse_result<std::optional<std::string>>> result
+        = get_optional<key, std::optional<std::string>>(doc)) {
+      return result.value().and_then(
+          [](auto&& path) -> parse_result<std::optional<std::string>> {
+            if (path.has_value() && path.value().empty())
+              return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                  "The checkpoint path must not be empty");
+            return {path};
+          });
+    } else
+      return {std::nullopt};
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::optional<std::string>> parse_geometry_cache(Document const& doc) {
+    if (std::optional<parse_result<std::optional<std::string>>> result
+        = get_optional<key, std::optional<std::string>>(doc)) {
+      return result.value().and_then(
+          [](auto&& directory) -> parse_result<std::optional<std::string>> {
+            if (directory.has_value() && directory.value().empty())
+              return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                  "The geometry cache directory must not be empty");
+            return {directory};
+          });
+    } else
+      return {std::nullopt};
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::optional<std::string>> parse_spill(Document const& doc) {
+    if (std::optional<parse_result<std::optional<std::string>>> result
+        = get_optional<key, std::optional<std::string>>(doc)) {
+      return result.value().and_then(
+          [](auto&& path) -> parse_result<std::optional<std::string>> {
+            if (path.has_value() && path.value().empty())
+              return parse_error::from_msg<key, CODE_BAD_VALUE>("The spill path must not be empty");
+            return {path};
+          });
+    } else
+      return {std::nullopt};
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::size_t> parse_spill_limit(Document const& doc) {
+    return get_optional<key, int>(doc)
+        .value_or(parse_result<int>{100000})
+        .and_then([](auto&& limit) -> parse_result<std::size_t> {
+          if (limit <= 0)
+            return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                "The number of results held in memory must be positive");
+          return static_cast<std::size_t>(limit);
+        });
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::size_t> parse_checkpoint_interval(Document const& doc) {
+    return get_optional<key, int>(doc)
+        .value_or(parse_result<int>{600})
+        .and_then([](auto&& interval) -> parse_result<std::size_t> {
+          if (interval <= 0)
+            return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                "The checkpoint interval must be a positive number of seconds");
+          return static_cast<std::size_t>(interval);
+        });
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::optional<std::size_t>> parse_max_time(Document const& doc) {
+    if (std::optional<parse_result<std::optional<int>>> result
+        = get_optional<key, std::optional<int>>(doc)) {
+      return result.value().and_then(
+          [](auto&& seconds) -> parse_result<std::optional<std::size_t>> {
+            if (!seconds.has_value()) return {std::nullopt};
+            if (seconds.value() <= 0)
+              return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                  "The time budget must be a positive number of seconds");
+            return {std::make_optional(static_cast<std::size_t>(seconds.value()))};
+          });
+    } else
+      return {std::nullopt};
+  }
+
+  template <string_literal key, class T, class Document>
+  parse_result<std::optional<T>> parse_objective_threshold(Document const& doc) {
+    if (std::optional<parse_result<std::optional<double>>> result
+        = get_optional<key, std::optional<double>>(doc)) {
+      return result.value().and_then([](auto&& threshold) -> parse_result<std::optional<T>> {
+        if (!threshold.has_value()) return {std::nullopt};
+        if (threshold.value() < 0)
+          return parse_error::from_msg<key, CODE_BAD_VALUE>(
+              "The objective threshold must not be negative");
+        return {std::make_optional(static_cast<T>(threshold.value()))};
+      });
+    } else
+      return {std::nullopt};
+  }
+
+  template <string_literal key, class Document>
+  parse_result<std::optional<iterations_t>> parse_max_stagnation(Document const& doc) {
+    if (std::optional<parse_result<std::optional<long long>>> result
+        = get_optional<key, std::optional<long long>>(doc)) {
+      return result.value().and_then(
+          [](auto&& iterations) -> parse_result<std::optional<iterations_t>> {
+            if (!iterations.has_value()) return {std::nullopt};
+            if (iterations.value() <= 0)
+              return parse_error::from_msg<key, CODE_BAD_VALUE>(
+                  "The number of iterations without improvement must be a positive integer "
+                  "number");
+            return {std::make_optional(static_cast<iterations_t>(iterations.value()))};
+          });
+    } else
+      return {std::nullopt};
+  }
+
+  /*
+   * The parameters of the objective function in doc, on top of the ones of a run with configuration
+   * base. If "shell_weights" are given, the arrays which depend on them are recomputed unless they
+   * are given as well, otherwise the ones of base are kept
+   */
   template <class T, class Document>
-  parse_result<configuration<T>> parse_config_for_prec(Document const& doc) {
+  parse_result<objective_variant<T>> parse_objective_variant(Document const& doc,
+                                                             configuration<T> const& base) {
+    auto geometry = base.geometry.get();
+    const bool reweighted = accessor<Document>::contains(doc, "shell_weights");
+    auto weights = reweighted ? config::parse_shell_weights<"shell_weights", T>(
+                                    doc, base.sublattice_mode, base.shell_radii)
+                              : parse_result<std::vector<shell_weights_t<T>>>{base.shell_weights};
+    return weights.and_then([&](auto&& w) {
+      auto structure = base.structure.structure();
+      const auto parse_or_keep
+          = [&](std::string_view key, auto&& parse,
+                std::vector<cube_t<T>> const& current) -> parse_result<std::vector<cube_t<T>>> {
+        if (reweighted || accessor<Document>::contains(doc, key.data())) return parse();
+        return {current};
+      };
+      return parse_or_keep(
+                 "prefactors",
+                 [&] {
+                   return config::parse_prefactors<"prefactors", T>(
+                       doc, base.sublattice_mode, core::structure<T>{structure}, base.composition,
+                       base.shell_radii, w, geometry);
+                 },
+                 base.prefactors)
+          .combine(parse_or_keep(
+              "pair_weights",
+              [&] {
+                return config::parse_pair_weights<"pair_weights", T>(
+                    doc, base.sublattice_mode, core::structure<T>{structure}, base.composition, w);
+              },
+              base.pair_weights))
+          .combine(parse_or_keep(
+              "target_objective",
+              [&] {
+                return config::parse_target_objective<"target_objective", T>(
+                    doc, base.sublattice_mode, core::structure<T>{structure}, base.composition, w);
+              },
+              base.target_objective))
+          .and_then([&](auto&& arrays) -> parse_result<objective_variant<T>> {
+            auto [prefactors, pair_weights, target_objective] = arrays;
+            return objective_variant<T>{w, std::move(prefactors), std::move(pair_weights),
+                                        std::move(target_objective)};
+          });
+    });
+  }
+
+  /*
+   * Further objective functions which are evaluated on the bonds of each configuration of the run.
+   * Since the bonds are only counted in the shells of the run, a variant must weight the same
+   * shells
+   */
+  template <string_literal key, class T, class Document>
+  parse_result<std::vector<objective_variant<T>>> parse_variants(Document const& doc,
+                                                                 configuration<T> const& base) {
+    using result_t = parse_result<std::vector<objective_variant<T>>>;
+    if (!accessor<Document>::contains(doc, key.data))
+      return result_t{std::vector<objective_variant<T>>{}};
+    const auto variants = accessor<Document>::get(doc, key.data);
+    using variant_doc_t = std::decay_t<decltype(variants)>;
+    if (!accessor<variant_doc_t>::is_list(variants))
+      return parse_error::from_msg<key, CODE_BAD_VALUE>(
+          "The variants must be given as a list of documents");
+    std::vector<objective_variant<T>> parsed;
+    for (auto const& variant : variants) {
+      using item_t = std::decay_t<decltype(variant)>;
+      const auto bad_variant = [&](std::string const& msg) -> result_t {
+        return parse_error::from_msg<key, CODE_BAD_VALUE>(
+            format_string("Variant %i: %s", parsed.size(), msg));
+      };
+      if (!accessor<item_t>::is_document(variant))
+        return bad_variant("A variant must be a document");
+      auto validation_result = accessor<item_t>::validate_keys(variant, VARIANT_KEYS);
+      if (validation_result.has_value()) return bad_variant(validation_result->msg);
+      auto result = parse_objective_variant<T>(variant, base);
+      if (result.failed()) return bad_variant(result.error().msg);
+      auto v = result.result();
+      for (auto sigma = 0; sigma < v.shell_weights.size(); ++sigma)
+        if (!std::ranges::equal(v.shell_weights[sigma] | views::keys,
+                                base.shell_weights[sigma] | views::keys))
+          return bad_variant("A variant must weight the same shells as the main objective");
+      parsed.push_back(std::move(v));
+    }
+    return result_t{std::move(parsed)};
+  }
+
+  /*
+   * The composition is read from composition_doc, all other parameters from doc. The neighbor
+   * analysis is recorded in geometry, which is carried on by the configuration
+   */
+  template <class T, class Document, class CompositionDocument = Document>
+  parse_result<configuration<T>> parse_config_for_prec(
+      Document const& doc, CompositionDocument const& composition_doc,
+      std::shared_ptr<core::geometry_cache<T>> geometry = nullptr) {
     auto validation_result = accessor<Document>::validate_keys(doc, KNOWN_KEYS);
     if (validation_result.has_value()) return {*validation_result};
+    auto cache_directory = parse_geometry_cache<"geometry_cache">(doc);
+    if (cache_directory.failed()) return cache_directory.error();
+    auto spill = parse_spill<"spill">(doc).combine(parse_spill_limit<"spill_limit">(doc));
+    if (spill.failed()) return spill.error();
+    if (!geometry) geometry = std::make_shared<core::geometry_cache<T>>();
+    if (cache_directory.result().has_value())
+      geometry->set_directory(cache_directory.result().value());
     return parse_iteration_mode<"iteration_mode">(doc)
         .combine(parse_sublattice_mode<"sublattice_mode">(doc))
         .combine(parse_structure_config<"structure", T>(doc))
@@ -211,12 +474,12 @@ namespace sqsgen::io::config {
         .and_then([&](auto&& modes_and_sc) {
           auto [iteration_mode, sublattice_mode, sc] = modes_and_sc;
           auto structure = sc.structure();
-          return config::parse_composition<"composition", "sites">(doc, structure.species,
-                                                                   sublattice_mode)
+          return config::parse_composition<"composition", "sites">(
+                     composition_doc, structure.species, sublattice_mode)
               .and_then([&](auto&& composition) {
                 return config::parse_shell_radii<"shell_radii">(
                            doc, sublattice_mode, std::forward<core::structure<T>>(structure),
-                           composition)
+                           composition, geometry.get())
                     .combine(parse_iterations<"iterations">(
                         doc, std::forward<core::structure<T>>(structure), composition,
                         iteration_mode))
@@ -229,7 +492,7 @@ namespace sqsgen::io::config {
                             return config::parse_prefactors<"prefactors", T>(
                                        doc, sublattice_mode,
                                        std::forward<core::structure<T>>(structure), composition,
-                                       radii, weights)
+                                       radii, weights, geometry.get())
                                 .combine(config::parse_pair_weights<"pair_weights", T>(
                                     doc, sublattice_mode,
                                     std::forward<core::structure<T>>(structure), composition,
@@ -244,20 +507,29 @@ namespace sqsgen::io::config {
                                 .combine(
                                     parse_max_results_per_objective<"max_results_per_objective">(
                                         doc))
+                                .combine(parse_shared_memory<"shared_memory">(doc))
+                                .combine(parse_checkpoint<"checkpoint">(doc))
+                                .combine(parse_checkpoint_interval<"checkpoint_interval">(doc))
+                                .combine(parse_max_time<"max_time">(doc))
+                                .combine(
+                                    parse_objective_threshold<"objective_threshold", T>(doc))
+                                .combine(parse_max_stagnation<"max_stagnation">(doc))
+                                .combine(parse_compact_results<"compact_results">(doc))
+                                .combine(parse_deduplication<"deduplication">(doc))
                                 .and_then([&](auto&& arrays) -> parse_result<configuration<T>> {
                                   auto [prefactors, pair_weights, target_objective, chunk_size,
-                                        thread_config, to_keep, max_results_per_objective]
+                                        thread_config, to_keep, max_results_per_objective,
+                                        shared_memory, checkpoint, checkpoint_interval,
+                                        max_time, objective_threshold, max_stagnation,
+                                        compact_results, deduplication]
                                       = arrays;
-                                  if (std::any_of(seed.begin(), seed.end(),
-                                                  [](auto s) { return s.has_value(); })
-                                      && std::any_of(thread_config.begin(), thread_config.end(),
-                                                     [](auto t) { return t > 1; }))
-                                    return {parse_error::from_msg<"seed", CODE_BAD_VALUE>(
-                                        "A random seed is set but the thread configuration "
-                                        "specifies more than 1 thread; seeded runs require "
-                                        "(currently) "
-                                        "exactly 1 thread for reproducibility")};
-                                  return configuration<T>{
+                                  if (compact_results && deduplication != DEDUPLICATION_MODE_EXACT)
+                                    return parse_error::from_msg<"deduplication",
+                                                                 CODE_BAD_ARGUMENT>(
+                                        "Symmetrically equivalent results cannot be detected if "
+                                        "\"compact_results\" is set, since compact results do "
+                                        "not store their configuration");
+                                  configuration<T> config{
                                       sublattice_mode,
                                       iteration_mode,
                                       seed,
@@ -272,7 +544,26 @@ namespace sqsgen::io::config {
                                       chunk_size,
                                       thread_config,
                                       to_keep,
-                                      max_results_per_objective};
+                                      max_results_per_objective,
+                                      shared_memory,
+                                      checkpoint,
+                                      checkpoint_interval,
+                                      max_time,
+                                      objective_threshold,
+                                      max_stagnation,
+                                      compact_results,
+                                      deduplication,
+                                      {},
+                                      geometry,
+                                      cache_directory.result()};
+                                  return parse_variants<"variants", T>(doc, config)
+                                      .and_then([&](auto&& variants)
+                                                    -> parse_result<configuration<T>> {
+                                        config.variants = std::move(variants);
+                                        std::tie(config.spill, config.spill_limit)
+                                            = spill.result();
+                                        return std::move(config);
+                                      });
                                 });
                           });
                     });
@@ -280,9 +571,92 @@ namespace sqsgen::io::config {
         });
   }
 
+  template <class T, class Document>
+  parse_result<configuration<T>> parse_config_for_prec(Document const& doc) {
+    return parse_config_for_prec<T>(doc, doc);
+  }
+
+  /*
+   * A sweep runs the same parameters for each composition listed under "sweep". Apart from the
+   * composition, an entry may not override any parameter. Each entry writes a checkpoint of its
+   * own, the index of the entry is inserted before the extension of "checkpoint"
+   */
+  template <class T, class Document>
+  parse_result<std::vector<configuration<T>>> parse_sweep_for_prec(Document const& doc) {
+    using result_t = parse_result<std::vector<configuration<T>>>;
+    if (!accessor<Document>::contains(doc, "sweep"))
+      return parse_error::from_msg<"sweep", CODE_NOT_FOUND>(
+          "A sweep needs a list of compositions");
+    if (accessor<Document>::contains(doc, "composition"))
+      return parse_error::from_msg<"composition", CODE_BAD_ARGUMENT>(
+          "In a sweep, the composition is given by each entry of \"sweep\"");
+    const auto entries = accessor<Document>::get(doc, "sweep");
+    using entries_t = std::decay_t<decltype(entries)>;
+    if (!accessor<entries_t>::is_list(entries))
+      return parse_error::from_msg<"sweep", CODE_BAD_VALUE>(
+          "The sweep must be given as a list of documents");
+    std::vector<configuration<T>> configs;
+    // all entries share the neighbor analysis of the structure
+    auto geometry = std::make_shared<core::geometry_cache<T>>();
+    for (auto const& entry : entries) {
+      using entry_t = std::decay_t<decltype(entry)>;
+      const auto bad_entry = [&](std::string const& msg) -> result_t {
+        return parse_error::from_msg<"sweep", CODE_BAD_VALUE>(
+            format_string("Entry %i: %s", configs.size(), msg));
+      };
+      if (!accessor<entry_t>::is_document(entry)) return bad_entry("An entry must be a document");
+      auto validation_result = accessor<entry_t>::validate_keys(entry, SWEEP_KEYS);
+      if (validation_result.has_value()) return bad_entry(validation_result->msg);
+      auto config = parse_config_for_prec<T>(doc, entry, geometry);
+      if (config.failed()) {
+        auto error = config.error();
+        error.msg = format_string("Sweep entry %i: %s", configs.size(), error.msg);
+        return error;
+      }
+      auto parsed = config.result();
+      if (parsed.checkpoint.has_value()) {
+        auto path = std::filesystem::path(parsed.checkpoint.value());
+        auto extension = path.extension().string();
+        path.replace_extension(format_string("%i%s", configs.size(), extension));
+        parsed.checkpoint = path.string();
+      }
+      configs.push_back(std::move(parsed));
+    }
+    if (configs.empty())
+      return parse_error::from_msg<"sweep", CODE_BAD_VALUE>(
+          "A sweep needs at least one composition");
+    return result_t{std::move(configs)};
+  }
+
+  /*
+   * The configuration under which the results of a run with configuration base are rescored. Only
+   * the parameters of the objective function may change, see parse_objective_variant
+   */
+  template <class T, class Document>
+  parse_result<configuration<T>> parse_rescore_config(Document const& doc,
+                                                      configuration<T> const& base) {
+    auto validation_result = accessor<Document>::validate_keys(doc, RESCORE_KEYS);
+    if (validation_result.has_value()) return {*validation_result};
+    // results read from a file come without the neighbor analysis of their run
+    auto with_geometry{base};
+    if (!with_geometry.geometry)
+      with_geometry.geometry = std::make_shared<core::geometry_cache<T>>(base.geometry_cache);
+    return parse_objective_variant<T>(doc, with_geometry)
+        .combine(parse_threads_per_rank<"thread_config">(doc))
+        .and_then([&](auto&& parsed) -> parse_result<configuration<T>> {
+          auto [variant, thread_config] = parsed;
+          auto config = with_geometry.with_objective(variant);
+          config.thread_config = std::move(thread_config);
+          return config;
+        });
+  }
+
   template <class Document>
   parse_result<configuration<float>, configuration<double>> parse_config(Document const& doc) {
     using result_t = parse_result<configuration<float>, configuration<double>>;
+    if (accessor<Document>::contains(doc, "sweep"))
+      return parse_error::from_msg<"sweep", CODE_BAD_ARGUMENT>(
+          "A sweep yields one configuration per composition and must be parsed as a sweep");
     return parse_precision<"prec">(doc).and_then([&](auto&& prec) -> result_t {
       if (prec == PREC_DOUBLE)
         return parse_config_for_prec<double, Document>(doc).and_then(
@@ -293,5 +667,21 @@ namespace sqsgen::io::config {
       throw std::runtime_error("Unsupported precision");
     });
   }
+
+  template <class Document>
+  parse_result<std::vector<configuration<float>>, std::vector<configuration<double>>> parse_sweep(
+      Document const& doc) {
+    using result_t
+        = parse_result<std::vector<configuration<float>>, std::vector<configuration<double>>>;
+    return parse_precision<"prec">(doc).and_then([&](auto&& prec) -> result_t {
+      if (prec == PREC_DOUBLE)
+        return parse_sweep_for_prec<double>(doc).and_then(
+            [](auto&& configs) -> result_t { return {configs}; });
+      if (prec == PREC_SINGLE)
+        return parse_sweep_for_prec<float>(doc).and_then(
+            [](auto&& configs) -> result_t { return {configs}; });
+      throw std::runtime_error("Unsupported precision");
+    });
+  }
 }  // namespace sqsgen::io::config
 #endif  // SQSGEN_IO_CONFIG_COMBINED_H
@@ -6,6 +6,7 @@
 #define SQSGEN_IO_CONFIG_SHELL_RADII_H
 
 #include "sqsgen/core/config.h"
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/io/config/shared.h"
 #include "sqsgen/io/parsing.h"
@@ -24,10 +25,16 @@ namespace sqsgen::io::config {
   namespace detail {
     template <class T> using accepted_types_t = parse_result<std::vector<T>, ShellRadiiDetection>;
 
+    // the detected radii are looked up in geometry first, if it is given
     template <string_literal key, class T, class Document>
     parse_result<std::vector<T>> parse_radii(Document const& doc, accepted_types_t<T>&& value,
-                                             core::structure<T>&& structure) {
+                                             core::structure<T>&& structure,
+                                             core::geometry_cache<T>* geometry) {
       using out_t = parse_result<std::vector<T>>;
+      const auto detect = [&](ShellRadiiDetection mode, T a, T b, auto&& fn) -> std::vector<T> {
+        if (!geometry) return fn();
+        return geometry->shell_radii(structure, {static_cast<T>(mode), a, b}, fn);
+      };
       return value.template collapse<std::vector<T>>(
           [&](ShellRadiiDetection&& mode) -> out_t {
             if (mode == SHELL_RADII_DETECTION_INVALID) {
@@ -40,8 +47,9 @@ namespace sqsgen::io::config {
                   .combine(get_optional<"rtol", T>(doc).value_or(T(rtol_default<T>)))
                   .and_then([&](auto&& params) -> out_t {
                     auto [atol, rtol] = params;
-                    return core::distances_naive(std::forward<core::structure<T>>(structure), atol,
-                                                 rtol);
+                    return detect(mode, atol, rtol, [&] {
+                      return core::distances_naive(core::structure<T>{structure}, atol, rtol);
+                    });
                   });
             }
             if (mode == SHELL_RADII_DETECTION_PEAK) {
@@ -51,8 +59,10 @@ namespace sqsgen::io::config {
                       get_optional<"peak_isolation", T>(doc).value_or(T(peak_isolation_default<T>)))
                   .and_then([&](auto&& params) -> out_t {
                     auto [bin_width, peak_isolation] = params;
-                    return core::distances_histogram(std::forward<core::structure<T>>(structure),
-                                                     bin_width, peak_isolation);
+                    return detect(mode, bin_width, peak_isolation, [&] {
+                      return core::distances_histogram(core::structure<T>{structure}, bin_width,
+                                                       peak_isolation);
+                    });
                   });
             }
             return std::vector<T>{};
@@ -77,12 +87,13 @@ namespace sqsgen::io::config {
 
     struct shell_radii_parser<key, SUBLATTICE_MODE_INTERACT, T> {
       template <class Document>
-      static radii_t<T> parse(Document const& doc, core::structure<T>&& structure) {
+      static radii_t<T> parse(Document const& doc, core::structure<T>&& structure,
+                              core::geometry_cache<T>* geometry) {
         return parse_radii<key, T>(
                    doc,
                    get_either_optional<key, std::vector<T>, ShellRadiiDetection>(doc).value_or(
                        detail::accepted_types_t<T>{SHELL_RADII_DETECTION_PEAK}),
-                   std::forward<core::structure<T>>(structure))
+                   std::forward<core::structure<T>>(structure), geometry)
             .and_then([&](auto&& radii) -> radii_t<T> { return stl_matrix_t<T>{radii}; });
       }
     };
@@ -91,7 +102,8 @@ namespace sqsgen::io::config {
     struct shell_radii_parser<key, SUBLATTICE_MODE_SPLIT, T> {
       template <class Document>
       static radii_t<T> parse(Document const& doc, core::structure<T>&& structure,
-                              std::vector<sublattice> const& sublattices) {
+                              std::vector<sublattice> const& sublattices,
+                              core::geometry_cache<T>* geometry) {
         if (accessor<Document>::contains(doc, key.data)) {
           // otherwise we expect to object to be a list and hold the radii spec. for each sl
           auto list = accessor<Document>::get(doc, key.data);
@@ -103,7 +115,7 @@ namespace sqsgen::io::config {
           auto default_radii = [&](auto&& subdoc, auto&& sublattice) {
             return parse_radii<key, T>(
                 doc, get_either<KEY_NONE, std::vector<T>, ShellRadiiDetection>(subdoc),
-                std::move(structure.sliced(sublattice.sites)));
+                std::move(structure.sliced(sublattice.sites)), geometry);
           };
           return lift<key>(default_radii, accessor_t::range(list), sublattices);
         }
@@ -111,7 +123,7 @@ namespace sqsgen::io::config {
         auto default_radii = [&](auto&& sublattice) -> parse_result<std::vector<T>> {
           return detail::parse_radii<key, T>(
               doc, detail::accepted_types_t<T>{SHELL_RADII_DETECTION_PEAK},
-              std::move(structure.sliced(sublattice.sites)));
+              std::move(structure.sliced(sublattice.sites)), geometry);
         };
         return lift<key>(default_radii, sublattices);
       }
@@ -121,15 +133,16 @@ namespace sqsgen::io::config {
   template <string_literal key, class T, class Document>
   radii_t<T> parse_shell_radii(Document const& doc, SublatticeMode mode,
                                core::structure<T>&& structure,
-                               std::vector<sublattice> const& composition) {
+                               std::vector<sublattice> const& composition,
+                               core::geometry_cache<T>* geometry = nullptr) {
     return parse_for_mode<key>(
         [&] {
           return detail::shell_radii_parser<key, SUBLATTICE_MODE_INTERACT, T>::parse(
-              doc, std::forward<core::structure<T>>(structure));
+              doc, std::forward<core::structure<T>>(structure), geometry);
         },
         [&] {
           return detail::shell_radii_parser<key, SUBLATTICE_MODE_SPLIT, T>::parse(
-              doc, std::forward<core::structure<T>>(structure), composition);
+              doc, std::forward<core::structure<T>>(structure), composition, geometry);
         },
         mode);
   }
@@ -0,0 +1,144 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_IO_EXPORT_H
+#define SQSGEN_IO_EXPORT_H
+
+#include <BS_thread_pool.hpp>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sqsgen/io/structure.h"
+
+namespace sqsgen::io {
+
+  namespace detail {
+
+    // a POSIX ustar header, all numbers are octal strings
+    struct tar_header {
+      std::array<char, 100> name{};
+      std::array<char, 8> mode{};
+      std::array<char, 8> uid{};
+      std::array<char, 8> gid{};
+      std::array<char, 12> size{};
+      std::array<char, 12> mtime{};
+      std::array<char, 8> checksum{};
+      char type{'0'};
+      std::array<char, 100> link_name{};
+      std::array<char, 6> magic{'u', 's', 't', 'a', 'r', '\0'};
+      std::array<char, 2> version{'0', '0'};
+      std::array<char, 32> user_name{};
+      std::array<char, 32> group_name{};
+      std::array<char, 8> dev_major{};
+      std::array<char, 8> dev_minor{};
+      std::array<char, 155> prefix{};
+      std::array<char, 12> padding{};
+    };
+    static_assert(sizeof(tar_header) == 512);
+
+    static constexpr std::size_t TAR_BLOCK_SIZE = 512;
+
+    template <std::size_t N> void put_octal(std::array<char, N>& field, std::uint64_t value) {
+      auto text = format_string("%0*o", static_cast<int>(N - 1), value);
+      if (text.size() > N - 1) throw std::out_of_range("Value does not fit into the tar header");
+      std::memcpy(field.data(), text.data(), text.size());
+    }
+
+    inline tar_header make_tar_header(std::string const& name, std::uint64_t size) {
+      if (name.size() > 99)
+        throw std::invalid_argument(format_string("File name \"%s\" is too long", name));
+      tar_header header;
+      std::memcpy(header.name.data(), name.data(), name.size());
+      put_octal(header.mode, 0644);
+      put_octal(header.uid, 0);
+      put_octal(header.gid, 0);
+      put_octal(header.size, size);
+      put_octal(header.mtime, 0);
+      // the checksum is computed with the checksum field filled with blanks
+      header.checksum.fill(' ');
+      std::uint64_t checksum{0};
+      for (auto c : std::as_bytes(std::span(&header, 1)))
+        checksum += static_cast<unsigned char>(c);
+      auto text = format_string("%06o", checksum);
+      std::memcpy(header.checksum.data(), text.data(), text.size());
+      header.checksum[6] = '\0';
+      return header;
+    }
+
+    inline std::size_t tar_padding(std::size_t size) {
+      return (TAR_BLOCK_SIZE - size % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+    }
+
+  }  // namespace detail
+
+  /*
+   * Formats count structures in parallel. make(i) creates the i-th structure and is called
+   * concurrently from the worker threads. The texts are returned in order
+   */
+  template <class Fn>
+  std::vector<std::string> format_structures(std::size_t count, Fn&& make, StructureFormat format,
+                                             std::size_t num_threads = 0) {
+    std::vector<std::string> texts(count);
+    if (count == 0) return texts;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    BS::thread_pool<> pool(num_threads == 0 ? std::thread::hardware_concurrency() : num_threads);
+    pool.detach_loop(std::size_t{0}, count, [&](std::size_t index) {
+      try {
+        texts[index] = io::format(make(index), format);
+      } catch (...) {
+        std::scoped_lock lock(error_mutex);
+        if (!error) error = std::current_exception();
+      }
+    });
+    pool.wait();
+    if (error) std::rethrow_exception(error);
+    return texts;
+  }
+
+  // the texts concatenated into a single multi-frame file, written with a single call
+  inline void write_frames(std::ostream& out, std::vector<std::string> const& frames,
+                           std::string const& separator = "") {
+    std::string buffer;
+    std::size_t size{0};
+    for (auto const& frame : frames) size += frame.size() + separator.size();
+    buffer.reserve(size);
+    for (auto const& frame : frames) buffer.append(frame).append(separator);
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out.good()) throw std::runtime_error("Failed to write the structures");
+  }
+
+  // an uncompressed tar archive, one file per entry, written with a single call
+  inline void write_tar(std::ostream& out, std::vector<std::string> const& names,
+                        std::vector<std::string> const& contents) {
+    if (names.size() != contents.size())
+      throw std::invalid_argument("Each file in the archive needs a name");
+    std::size_t size{2 * detail::TAR_BLOCK_SIZE};
+    for (auto const& content : contents)
+      size += detail::TAR_BLOCK_SIZE + content.size() + detail::tar_padding(content.size());
+    std::string buffer;
+    buffer.reserve(size);
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      auto header = detail::make_tar_header(names[i], contents[i].size());
+      buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+      buffer.append(contents[i]);
+      buffer.append(detail::tar_padding(contents[i].size()), '\0');
+    }
+    // the archive ends with two empty blocks
+    buffer.append(2 * detail::TAR_BLOCK_SIZE, '\0');
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out.good()) throw std::runtime_error("Failed to write the archive");
+  }
+
+}  // namespace sqsgen::io
+
+#endif  // SQSGEN_IO_EXPORT_H
@@ -8,6 +8,7 @@
 #include <nlohmann/json.hpp>
 #include <utility>
 
+#include "sqsgen/core/checkpoint.h"
 #include "sqsgen/core/config.h"
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/core/results.h"
@@ -173,6 +174,24 @@ template <class T> struct adl_serializer<core::structure_config<T>> {
   }
 };
 
+template <class T> struct adl_serializer<core::objective_variant<T>> {
+  static void to_json(json& j, core::objective_variant<T> const& v) {
+    j = json{
+        {"shell_weights", v.shell_weights},
+        {"prefactors", v.prefactors},
+        {"pair_weights", v.pair_weights},
+        {"target_objective", v.target_objective},
+    };
+  }
+
+  static void from_json(const json& j, core::objective_variant<T>& v) {
+    j.at("shell_weights").get_to<std::vector<shell_weights_t<T>>>(v.shell_weights);
+    j.at("prefactors").get_to<std::vector<cube_t<T>>>(v.prefactors);
+    j.at("pair_weights").get_to<std::vector<cube_t<T>>>(v.pair_weights);
+    j.at("target_objective").get_to<std::vector<cube_t<T>>>(v.target_objective);
+  }
+};
+
 template <class T> struct adl_serializer<core::configuration<T>> {
   static void to_json(json& j, core::configuration<T> const& data) {
     j = json{{"sublattice_mode", data.sublattice_mode},
@@ -189,7 +208,19 @@ template <class T> struct adl_serializer<core::configuration<T>> {
              {"chunk_size", data.chunk_size},
              {"thread_config", data.thread_config},
              {"keep", data.keep},
-             {"max_results_per_objective", data.max_results_per_objective}};
+             {"max_results_per_objective", data.max_results_per_objective},
+             {"shared_memory", data.shared_memory},
+             {"checkpoint", data.checkpoint},
+             {"checkpoint_interval", data.checkpoint_interval},
+             {"geometry_cache", data.geometry_cache},
+             {"spill", data.spill},
+             {"spill_limit", data.spill_limit},
+             {"max_time", data.max_time},
+             {"objective_threshold", data.objective_threshold},
+             {"max_stagnation", data.max_stagnation},
+             {"compact_results", data.compact_results},
+             {"deduplication", data.deduplication},
+             {"variants", data.variants}};
   }
 
   static void from_json(const json& j, core::configuration<T>& c) {
@@ -209,6 +240,23 @@ template <class T> struct adl_serializer<core::configuration<T>> {
     j.at("keep").get_to<std::size_t>(c.keep);
     j.at("max_results_per_objective")
         .get_to<std::optional<std::size_t>>(c.max_results_per_objective);
+    c.shared_memory = j.value("shared_memory", false);
+    if (j.contains("checkpoint"))
+      j.at("checkpoint").get_to<std::optional<std::string>>(c.checkpoint);
+    c.checkpoint_interval = j.value("checkpoint_interval", std::size_t{600});
+    if (j.contains("geometry_cache"))
+      j.at("geometry_cache").get_to<std::optional<std::string>>(c.geometry_cache);
+    if (j.contains("spill")) j.at("spill").get_to<std::optional<std::string>>(c.spill);
+    c.spill_limit = j.value("spill_limit", std::size_t{100000});
+    if (j.contains("max_time")) j.at("max_time").get_to<std::optional<std::size_t>>(c.max_time);
+    if (j.contains("objective_threshold"))
+      j.at("objective_threshold").get_to<std::optional<T>>(c.objective_threshold);
+    if (j.contains("max_stagnation"))
+      j.at("max_stagnation").get_to<std::optional<iterations_t>>(c.max_stagnation);
+    c.compact_results = j.value("compact_results", false);
+    c.deduplication = j.value("deduplication", DEDUPLICATION_MODE_EXACT);
+    if (j.contains("variants"))
+      j.at("variants").get_to<std::vector<core::objective_variant<T>>>(c.variants);
   }
 };
 
@@ -216,15 +264,23 @@ template <class T> struct adl_serializer<sqs_result<T, SUBLATTICE_MODE_INTERACT>
   static void to_json(json& j, sqs_result<T, SUBLATTICE_MODE_INTERACT> const& data) {
     // at this point we want to have a faster array serialization (flat) -> we do not need human
     // readability at this point
-    j = json{{"objective", data.objective},
-             {"species", data.species},
-             {"sro", binary_adapter<T, 3>::save(data.sro)}};
+    if (data.compact())
+      j = json{{"objective", data.objective}, {"iteration", data.iteration}};
+    else {
+      j = json{{"objective", data.objective},
+               {"species", data.species.unpack()},
+               {"iteration", data.iteration}};
+      // SRO parameters are only written if they were computed, otherwise they are recomputed
+      if (data.sro.size() > 0) j["sro"] = binary_adapter<T, 3>::save(data.sro);
+    }
   }
 
   static void from_json(const json& j, sqs_result<T, SUBLATTICE_MODE_INTERACT>& r) {
     j.at("objective").get_to<T>(r.objective);
-    j.at("species").get_to<configuration_t>(r.species);
-    r.sro = binary_adapter<T, 3>::load(j.at("sro"));
+    r.iteration = j.value("iteration", iterations_t{0});
+    if (j.contains("species"))
+      r.species = packed_configuration_t(j.at("species").get<configuration_t>());
+    if (j.contains("sro")) r.sro = binary_adapter<T, 3>::load(j.at("sro"));
   }
 };
 
@@ -272,6 +328,7 @@ template <class T, SublatticeMode Mode> struct adl_serializer<core::sqs_result_p
         {"config", data.config},
         {"results", flattened},
     };
+    if (!data.variants.empty()) j["variants"] = data.variants;
   }
 
   static void from_json(const json& j, core::sqs_result_pack<T, Mode>& p) {
@@ -283,6 +340,31 @@ template <class T, SublatticeMode Mode> struct adl_serializer<core::sqs_result_p
                                        sqs_statistics_data<T>{}};
     p.config = config;
     j.at("statistics").get_to<sqs_statistics_data<T>>(p.statistics);
+    if (j.contains("variants"))
+      j.at("variants").get_to<std::vector<core::sqs_result_pack<T, Mode>>>(p.variants);
+  }
+};
+
+template <class T, SublatticeMode Mode> struct adl_serializer<core::sqs_checkpoint<T, Mode>> {
+  static void to_json(json& j, core::sqs_checkpoint<T, Mode> const& data) {
+    j = json{{"prec", std::is_same_v<T, float> ? PREC_SINGLE : PREC_DOUBLE},
+             {"config", data.config},
+             {"statistics", data.statistics},
+             {"results", data.results},
+             {"finished", data.finished},
+             {"rng_state", data.rng_state},
+             {"variant_results", data.variant_results}};
+  }
+
+  static void from_json(const json& j, core::sqs_checkpoint<T, Mode>& c) {
+    j.at("config").get_to<core::configuration<T>>(c.config);
+    j.at("statistics").get_to<sqs_statistics_data<T>>(c.statistics);
+    j.at("results").get_to<std::vector<sqs_result<T, Mode>>>(c.results);
+    j.at("finished").get_to<std::vector<bounds_t<iterations_t>>>(c.finished);
+    j.at("rng_state").get_to<std::vector<std::uint64_t>>(c.rng_state);
+    if (j.contains("variant_results"))
+      j.at("variant_results")
+          .get_to<std::vector<std::vector<sqs_result<T, Mode>>>>(c.variant_results);
   }
 };
 
@@ -309,6 +391,14 @@ namespace sqsgen {
                                                    {SUBLATTICE_MODE_SPLIT, "split"},
                                                })
 
+  NLOHMANN_JSON_SERIALIZE_ENUM(DeduplicationMode,
+                               {
+                                   {DEDUPLICATION_MODE_INVALID, nullptr},
+                                   {DEDUPLICATION_MODE_EXACT, "exact"},
+                                   {DEDUPLICATION_MODE_TRANSLATIONS, "translations"},
+                                   {DEDUPLICATION_MODE_SYMMETRY, "symmetry"},
+                               })
+
   NLOHMANN_JSON_SERIALIZE_ENUM(Timing, {
                                            {TIMING_UNDEFINED, nullptr},
                                            {TIMING_COMM, "comm"},
@@ -0,0 +1,190 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_IO_MERGE_H
+#define SQSGEN_IO_MERGE_H
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "sqsgen/core/statistics.h"
+#include "sqsgen/io/pack.h"
+
+namespace sqsgen::io {
+
+  namespace detail {
+
+    // the results of two runs can only be compared if they agree on these parameters
+    static constexpr std::array MERGE_KEYS{"sublattice_mode", "structure",     "composition",
+                                           "shell_radii",     "shell_weights", "prefactors",
+                                           "pair_weights",    "target_objective",
+                                           "deduplication",   "variants"};
+
+    template <class T>
+    void check_compatible(core::configuration<T> const& first, core::configuration<T> const& other,
+                          std::size_t shard) {
+      nlohmann::json lhs = first, rhs = other;
+      for (auto key : MERGE_KEYS)
+        if (lhs.at(key) != rhs.at(key))
+          throw std::invalid_argument(
+              format_string("Shard %i cannot be merged, its \"%s\" differs from the first shard",
+                            shard, key));
+    }
+
+  }  // namespace detail
+
+  /*
+   * Merges the result packs of independent runs, e.g. with different seeds or iteration ranges,
+   * one shard at a time. Only the keep best objectives with at most max_results_per_objective
+   * results each are held in memory. Compact results are regenerated with the seed of their shard
+   * when they are added, hence the merged pack is never compact
+   */
+  template <class T, SublatticeMode Mode> class pack_merger {
+    using wrapper_t = core::detail::sqs_result_wrapper<T, Mode>;
+
+    // the main objective and each variant
+    struct target {
+      core::configuration<T> config;
+      std::shared_ptr<core::structure<T>> structure;
+      core::detail::opt_config_t<T, Mode> opt_config;
+      sqs_statistics_data<T> statistics{};
+      core::sqs_result_collection<T, Mode> results;
+    };
+
+    std::optional<std::size_t> _keep;
+    std::size_t _num_shards{0};
+    std::vector<std::unique_ptr<target>> _targets;
+
+    static sqs_result<T, SUBLATTICE_MODE_INTERACT> expand(
+        core::detail::sqs_result_wrapper<T, SUBLATTICE_MODE_INTERACT>& result) {
+      if (result.compact()) result.materialize();
+      return std::move(static_cast<sqs_result<T, SUBLATTICE_MODE_INTERACT>&>(result));
+    }
+
+    static sqs_result<T, Mode> expand(wrapper_t&& result) {
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        return expand(result);
+      else {
+        std::vector<sqs_result<T, SUBLATTICE_MODE_INTERACT>> sublattices;
+        for (auto& sublattice : result.sublattices) sublattices.push_back(expand(sublattice));
+        return {result.objective, std::move(sublattices)};
+      }
+    }
+
+    void add(target& t, pack_view<T, Mode> const& view) {
+      auto const& config = view.config();
+      auto keep = std::max<std::size_t>(_keep.value_or(t.config.keep), 1);
+      auto max_results_per_objective = t.config.max_results_per_objective;
+      auto keys = core::detail::replay_keys<T, Mode>(config);
+      t.statistics = [&] {
+        auto stats = core::sqs_statistics<T>{t.statistics};
+        stats.merge(view.statistics());
+        return stats.data();
+      }();
+      // the objectives of a shard are sorted, nothing after a rejected objective can be accepted
+      for (std::size_t o = 0; o < view.size(); ++o) {
+        auto objective = view.objective(o);
+        if (objective > t.results.nth_best(keep - 1)) break;
+        for (std::size_t i = 0; i < view.num_results(o); ++i) {
+          if (max_results_per_objective.has_value()
+              && t.results.results_for_objective(objective) >= max_results_per_objective.value())
+            break;
+          t.results.insert(expand(wrapper_t{view.raw(o, i), t.structure, t.opt_config, keys}));
+        }
+        t.results.truncate(keep);
+      }
+    }
+
+    std::unique_ptr<target> make_target(core::configuration<T> const& config) {
+      auto t = std::make_unique<target>();
+      t->config = config;
+      t->config.compact_results = false;
+      t->structure = std::make_shared<core::structure<T>>(config.structure.structure());
+      t->opt_config = core::detail::from_opt_config<T, Mode>(
+          core::detail::opt_config_from_config<T, Mode>(core::configuration<T>{config}));
+      return t;
+    }
+
+    core::sqs_result_pack<T, Mode> finish(target& t) {
+      core::detail::opt_config_arg_t<T, Mode> opt_config;
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        opt_config = *t.opt_config;
+      else
+        for (auto const& c : t.opt_config) opt_config.push_back(*c);
+      return {core::configuration<T>{t.config}, std::move(opt_config), t.results.results(),
+              sqs_statistics_data<T>{t.statistics}};
+    }
+
+  public:
+    // keep overrides the number of objectives of the first shard
+    explicit pack_merger(std::optional<std::size_t> keep = std::nullopt) : _keep(keep) {}
+
+    void add(pack_view<T, Mode> const& view) {
+      if (_targets.empty()) {
+        _targets.push_back(make_target(view.config()));
+        for (std::size_t v = 0; v < view.num_variants(); ++v)
+          _targets.push_back(make_target(view.variant(v).config()));
+      } else
+        detail::check_compatible(_targets.front()->config, view.config(), _num_shards);
+      add(*_targets.front(), view);
+      for (std::size_t v = 0; v < view.num_variants(); ++v) add(*_targets[v + 1], view.variant(v));
+      ++_num_shards;
+    }
+
+    [[nodiscard]] std::size_t num_shards() const { return _num_shards; }
+
+    core::sqs_result_pack<T, Mode> finish() {
+      if (_targets.empty()) throw std::invalid_argument("There are no result packs to merge");
+      auto pack = finish(*_targets.front());
+      for (std::size_t v = 1; v < _targets.size(); ++v)
+        pack.variants.push_back(finish(*_targets[v]));
+      return pack;
+    }
+  };
+
+  using pack_merger_t = std::variant<pack_merger<float, SUBLATTICE_MODE_SPLIT>,
+                                     pack_merger<double, SUBLATTICE_MODE_SPLIT>,
+                                     pack_merger<float, SUBLATTICE_MODE_INTERACT>,
+                                     pack_merger<double, SUBLATTICE_MODE_INTERACT>>;
+
+  /*
+   * Merges num_shards packs, open(i) returns a pack_view_t of the i-th shard. The shards are opened
+   * one after another, and only one of them is open at a time
+   */
+  template <class Open>
+  sqs_result_pack_t merge_packs(std::size_t num_shards, Open&& open,
+                                std::optional<std::size_t> keep = std::nullopt) {
+    if (num_shards == 0) throw std::invalid_argument("There are no result packs to merge");
+    std::optional<pack_merger_t> merger;
+    for (std::size_t i = 0; i < num_shards; ++i) {
+      pack_view_t shard = open(i);
+      if (!merger.has_value())
+        merger = std::visit(
+            [&]<class T, SublatticeMode Mode>(pack_view<T, Mode> const&) -> pack_merger_t {
+              return pack_merger<T, Mode>(keep);
+            },
+            shard);
+      std::visit(
+          [&]<class T, SublatticeMode Mode>(pack_merger<T, Mode>& m) {
+            if (!std::holds_alternative<pack_view<T, Mode>>(shard))
+              throw std::invalid_argument(format_string(
+                  "Shard %i cannot be merged, it has a different precision or sublattice mode", i));
+            m.add(std::get<pack_view<T, Mode>>(shard));
+          },
+          merger.value());
+    }
+    return std::visit([](auto& m) -> sqs_result_pack_t { return m.finish(); }, merger.value());
+  }
+
+  inline sqs_result_pack_t merge_packs(std::vector<std::filesystem::path> const& paths,
+                                       std::optional<std::size_t> keep = std::nullopt) {
+    return merge_packs(paths.size(), [&](std::size_t i) { return open_pack(paths[i]); }, keep);
+  }
+
+}  // namespace sqsgen::io
+
+#endif  // SQSGEN_IO_MERGE_H
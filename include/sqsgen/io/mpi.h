@@ -5,10 +5,35 @@
 #ifndef SQSGEN_IO_MPI_H
 #define SQSGEN_IO_MPI_H
 
+#include <optional>
 #include <sqsgen/io/mpi/config.h>
 #include <sqsgen/io/mpi/requests.h>
+#include <sqsgen/io/mpi/shared.h>
+#include <vector>
 
 namespace sqsgen::io::mpi {
+
+  struct tree_node {
+    std::optional<int> parent;
+    std::vector<int> children;
+  };
+
+  /*
+   * Position of a rank within a binomial reduction tree rooted at the head rank. Children are
+   * ordered such that the ones with the smallest subtrees (which finish first) come first
+   */
+  inline tree_node reduction_tree(int rank, int num_ranks) {
+    tree_node node;
+    for (int mask = 1; mask < num_ranks; mask <<= 1) {
+      if (rank & mask) {
+        node.parent = rank - mask;
+        break;
+      }
+      if (rank + mask < num_ranks) node.children.push_back(rank + mask);
+    }
+    return node;
+  }
+
 #ifdef WITH_MPI
   template <class Message, class Fn>
   void recv_all(mpl::communicator& comm, Message&& buffer, Fn&& fn, int source = mpl::any_source) {
@@ -47,6 +47,79 @@ namespace sqsgen::io::mpi {
   static constexpr int TAG_OBJECTIVE = 1;
   static constexpr int TAG_RESULT = 2;
   static constexpr int TAG_STATISTICS = 3;
+  static constexpr int TAG_BATCH_SIZE = 4;
+  static constexpr int TAG_BATCH = 5;
+
+  /*
+   * Flattens many results into four contiguous buffers, such that a whole batch can be
+   * transferred in a single message. A split mode result contributes its total objective followed
+   * by the objectives of its sublattices. All results of a batch must share the same shape
+   */
+  template <class T> struct result_batch {
+    std::vector<T> objectives;
+    std::vector<iterations_t> iterations;
+    configuration_t species;
+    std::vector<T> sro;
+
+    void push_back(sqs_result<T, SUBLATTICE_MODE_INTERACT> const& result) {
+      objectives.push_back(result.objective);
+      iterations.push_back(result.iteration);
+      auto packed = result.species.unpack();
+      species.insert(species.end(), packed.begin(), packed.end());
+      sro.insert(sro.end(), result.sro.data(), result.sro.data() + result.sro.size());
+    }
+
+    void push_back(sqs_result<T, SUBLATTICE_MODE_SPLIT> const& result) {
+      objectives.push_back(result.objective);
+      for (auto const& sublattice : result.sublattices) push_back(sublattice);
+    }
+
+    template <SublatticeMode Mode>
+    void resize(sqs_result<T, Mode> const& shape, std::size_t num_results) {
+      result_batch sizes;
+      sizes.push_back(shape);
+      objectives.resize(sizes.objectives.size() * num_results);
+      iterations.resize(sizes.iterations.size() * num_results);
+      species.resize(sizes.species.size() * num_results);
+      sro.resize(sizes.sro.size() * num_results);
+    }
+
+    template <SublatticeMode Mode>
+    std::vector<sqs_result<T, Mode>> unpack(sqs_result<T, Mode> const& shape) const {
+      result_batch sizes;
+      sizes.push_back(shape);
+      std::size_t objective_offset{0}, iteration_offset{0}, species_offset{0}, sro_offset{0};
+      const auto unpack_one = [&](sqs_result<T, SUBLATTICE_MODE_INTERACT> const& s) {
+        auto num_shells{detail::dimension<0>(s.sro)}, num_species{detail::dimension<1>(s.sro)};
+        sqs_result<T, SUBLATTICE_MODE_INTERACT> result{
+            objectives[objective_offset],
+            configuration_t(species.begin() + species_offset,
+                            species.begin() + species_offset + s.species.size()),
+            cube_t<T>(Eigen::TensorMap<const cube_t<T>>(sro.data() + sro_offset, num_shells,
+                                                        num_species, num_species)),
+            iterations[iteration_offset++]};
+        ++objective_offset;
+        species_offset += s.species.size();
+        sro_offset += s.sro.size();
+        return result;
+      };
+      std::vector<sqs_result<T, Mode>> results;
+      results.reserve(objectives.size() / sizes.objectives.size());
+      while (objective_offset < objectives.size()) {
+        if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+          results.push_back(unpack_one(shape));
+        else {
+          T total_objective = objectives[objective_offset++];
+          std::vector<sqs_result<T, SUBLATTICE_MODE_INTERACT>> sublattices;
+          sublattices.reserve(shape.sublattices.size());
+          for (auto const& sublattice : shape.sublattices)
+            sublattices.push_back(unpack_one(sublattice));
+          results.push_back(sqs_result<T, Mode>{total_objective, std::move(sublattices)});
+        }
+      }
+      return results;
+    }
+  };
 
   template <class, class> class request;
 
@@ -75,12 +148,14 @@ namespace sqsgen::io::mpi {
       configuration_t species_buff;
       std::vector<T> objective_buff;
       T total_objective;
+      iterations_t iteration{result.sublattices.empty() ? 0 : result.sublattices.front().iteration};
       std::size_t num_sublattices{result.sublattices.size()};
       std::vector<long> num_shells, num_atoms, num_species;
       if constexpr (std::is_same_v<RequestType, detail::outbound_request>) {
         for (auto sl : result.sublattices) {
           sro_buff.insert(sro_buff.end(), sl.sro.data(), sl.sro.data() + sl.sro.size());
-          species_buff.insert(species_buff.end(), sl.species.begin(), sl.species.end());
+          auto species = sl.species.unpack();
+          species_buff.insert(species_buff.end(), species.begin(), species.end());
           objective_buff.push_back(sl.objective);
           num_shells.push_back(detail::dimension<0>(sl.sro));
           num_species.push_back(detail::dimension<1>(sl.sro));
@@ -108,7 +183,7 @@ namespace sqsgen::io::mpi {
       mpl::vector_layout<long> num_atoms_layout(num_atoms.size());
       mpl::vector_layout<long> num_species_layout(num_species.size());
       mpl::vector_layout<long> num_shells_layout(num_shells.size());
-      mpl::heterogeneous_layout l(total_objective, num_sublattices,
+      mpl::heterogeneous_layout l(total_objective, iteration, num_sublattices,
                                   mpl::make_absolute(num_atoms.data(), num_atoms_layout),
                                   mpl::make_absolute(objective_buff.data(), objective_layout),
                                   mpl::make_absolute(species_buff.data(), species_layout),
@@ -135,7 +210,8 @@ namespace sqsgen::io::mpi {
                                     species_buff.begin() + offset_species + num_atoms[sigma]),
                     cube_t<T>(Eigen::TensorMap<cube_t<T>>(sro_buff.data() + offset_sro,
                                                           num_shells[sigma], num_species[sigma],
-                                                          num_species[sigma]))});
+                                                          num_species[sigma])),
+                    iteration});
                 offset_species += num_atoms[sigma];
                 offset_sro += num_shells[sigma] * num_species[sigma] * num_species[sigma];
               }
@@ -171,10 +247,14 @@ namespace sqsgen::io::mpi {
     std::vector<std::pair<value_t, int>> result_comm(mpl::communicator& comm, value_t&& result,
                                                      int to) {
       std::vector<T> sro_buff;
-      if constexpr (std::is_same_v<RequestType, detail::outbound_request>)
+      configuration_t species_buff;
+      if constexpr (std::is_same_v<RequestType, detail::outbound_request>) {
         sro_buff = std::vector(result.sro.data(), result.sro.data() + result.sro.size());
-      else
+        species_buff = result.species.unpack();
+      } else {
         sro_buff.resize(result.sro.size());
+        species_buff.resize(result.species.size());
+      }
       mpl::vector_layout<T> sro_layout(result.sro.size());
       mpl::vector_layout<specie_t> species_layout(result.species.size());
       std::size_t num_atoms{result.species.size()};
@@ -182,8 +262,9 @@ namespace sqsgen::io::mpi {
           num_species{detail::dimension<1>(result.sro)};
       assert(result.sro.size() == num_shells * num_species * num_species);
       mpl::heterogeneous_layout l(
-          result.objective, num_atoms, mpl::make_absolute(result.species.data(), species_layout),
-          num_shells, num_species, mpl::make_absolute(sro_buff.data(), sro_layout));
+          result.objective, result.iteration, num_atoms,
+          mpl::make_absolute(species_buff.data(), species_layout), num_shells, num_species,
+          mpl::make_absolute(sro_buff.data(), sro_layout));
       if constexpr (std::is_same_v<RequestType, detail::outbound_request>) {
         auto req = comm.isend(mpl::absolute, l, to, mpl::tag_t(tag));
         req.wait();
@@ -195,6 +276,7 @@ namespace sqsgen::io::mpi {
             [&, l](auto&& status) {
               auto req = comm.irecv(mpl::absolute, l, status.source(), mpl::tag_t(tag));
               req.wait();
+              result.species = packed_configuration_t(species_buff);
               result.sro = Eigen::TensorMap<cube_t<T>>(sro_buff.data(), num_shells, num_species,
                                                        num_species);
               results.push_back(std::make_pair(result, status.source()));
@@ -342,6 +424,72 @@ namespace sqsgen::io::mpi {
 #endif
   };
 
+  /*
+   * A batch of results is sent as two messages: the number of results (TAG_BATCH_SIZE) followed by
+   * the flattened buffers (TAG_BATCH). On the receiving side the first element of the buffer
+   * passed to recv determines the shape of all results in the batch
+   */
+  template <class T, SublatticeMode Mode, class RequestType>
+  class request<std::vector<sqs_result<T, Mode>>, RequestType> {
+#ifdef WITH_MPI
+    using value_t = std::vector<sqs_result<T, Mode>>;
+
+  public:
+    static constexpr auto tag = TAG_BATCH;
+
+    void send(mpl::communicator& comm, value_t&& results, int to) {
+      static_assert(std::is_same_v<RequestType, detail::outbound_request>);
+      long num_results{static_cast<long>(results.size())};
+      auto size_req = comm.isend(num_results, to, mpl::tag_t(TAG_BATCH_SIZE));
+      size_req.wait();
+      if (num_results == 0) return;
+      result_batch<T> batch;
+      for (auto const& result : results) batch.push_back(result);
+      auto l = layout(batch);
+      auto req = comm.isend(mpl::absolute, l, to, mpl::tag_t(tag));
+      req.wait();
+    }
+
+    auto recv(mpl::communicator& comm, value_t&& shape, int source) {
+      static_assert(std::is_same_v<RequestType, detail::inbound_request>);
+      if (shape.empty()) throw std::invalid_argument("a batch request requires a shape result");
+      std::vector<std::pair<value_t, int>> received;
+      detail::receive_messages<TAG_BATCH_SIZE>(
+          comm,
+          [&](auto&& status) {
+            long num_results{0};
+            auto size_req = comm.irecv(num_results, status.source(), mpl::tag_t(TAG_BATCH_SIZE));
+            size_req.wait();
+            value_t results;
+            if (num_results > 0) {
+              result_batch<T> batch;
+              batch.resize(shape.front(), static_cast<std::size_t>(num_results));
+              auto l = layout(batch);
+              auto req = comm.irecv(mpl::absolute, l, status.source(), mpl::tag_t(tag));
+              req.wait();
+              results = batch.unpack(shape.front());
+            }
+            received.push_back(std::make_pair(std::move(results), status.source()));
+          },
+          source);
+      return received;
+    }
+
+  private:
+    static auto layout(result_batch<T>& batch) {
+      mpl::vector_layout<T> objectives_layout(batch.objectives.size());
+      mpl::vector_layout<iterations_t> iterations_layout(batch.iterations.size());
+      mpl::vector_layout<specie_t> species_layout(batch.species.size());
+      mpl::vector_layout<T> sro_layout(batch.sro.size());
+      return mpl::heterogeneous_layout(
+          mpl::make_absolute(batch.objectives.data(), objectives_layout),
+          mpl::make_absolute(batch.iterations.data(), iterations_layout),
+          mpl::make_absolute(batch.species.data(), species_layout),
+          mpl::make_absolute(batch.sro.data(), sro_layout));
+    }
+#endif
+  };
+
 }  // namespace sqsgen::io::mpi
 
 #endif  // SQSGEN_IO_MPI_REQUESTS_H
@@ -0,0 +1,109 @@
+//
+// Created by Dominik Gehringer on 12.04.25.
+//
+
+#ifndef SQSGEN_IO_MPI_SHARED_H
+#define SQSGEN_IO_MPI_SHARED_H
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sqsgen/io/mpi/config.h"
+
+namespace sqsgen::io::mpi {
+#ifdef WITH_MPI
+
+  /*
+   * Groups all ranks which are able to share memory (i.e. which run on the same node). The ranks
+   * keep their relative order, hence the head rank is always the leader (rank 0) of its node
+   */
+  class node_communicator {
+    MPI_Comm _comm{MPI_COMM_NULL};
+
+  public:
+    explicit node_communicator(mpl::communicator const& comm) {
+      MPI_Comm_split_type(comm.native_handle(), MPI_COMM_TYPE_SHARED, comm.rank(), MPI_INFO_NULL,
+                          &_comm);
+    }
+
+    node_communicator(node_communicator const&) = delete;
+    node_communicator& operator=(node_communicator const&) = delete;
+
+    ~node_communicator() {
+      if (_comm != MPI_COMM_NULL) MPI_Comm_free(&_comm);
+    }
+
+    [[nodiscard]] MPI_Comm native_handle() const { return _comm; }
+
+    [[nodiscard]] int rank() const {
+      int rank;
+      MPI_Comm_rank(_comm, &rank);
+      return rank;
+    }
+
+    [[nodiscard]] int size() const {
+      int size;
+      MPI_Comm_size(_comm, &size);
+      return size;
+    }
+
+    [[nodiscard]] bool is_leader() const { return rank() == 0; }
+  };
+
+  /*
+   * A read-only array living in an MPI-3 shared memory window. Only the leader of the node
+   * allocates (and fills) the memory, all other ranks on the node map the leaders segment. The
+   * constructor is collective over the node communicator
+   */
+  template <class T>
+    requires std::is_trivially_copyable_v<T>
+  class shared_array {
+    MPI_Win _window{MPI_WIN_NULL};
+    T const* _data{nullptr};
+    std::size_t _size{0};
+
+  public:
+    shared_array(node_communicator const& node, std::vector<T> const& values) {
+      auto leader = node.is_leader();
+      unsigned long long size{leader ? values.size() : 0};
+      MPI_Bcast(&size, 1, MPI_UNSIGNED_LONG_LONG, 0, node.native_handle());
+      _size = static_cast<std::size_t>(size);
+
+      T* base{nullptr};
+      MPI_Aint bytes = leader ? static_cast<MPI_Aint>(_size * sizeof(T)) : 0;
+      MPI_Win_allocate_shared(bytes, sizeof(T), MPI_INFO_NULL, node.native_handle(), &base,
+                              &_window);
+      if (leader) std::copy(values.begin(), values.end(), base);
+      MPI_Win_fence(0, _window);
+
+      MPI_Aint segment_size;
+      int displacement_unit;
+      T* leader_base{nullptr};
+      MPI_Win_shared_query(_window, 0, &segment_size, &displacement_unit, &leader_base);
+      _data = leader_base;
+    }
+
+    shared_array(shared_array const&) = delete;
+    shared_array& operator=(shared_array const&) = delete;
+
+    shared_array(shared_array&& other) noexcept
+        : _window(std::exchange(other._window, MPI_WIN_NULL)),
+          _data(std::exchange(other._data, nullptr)),
+          _size(std::exchange(other._size, 0)) {}
+
+    ~shared_array() {
+      if (_window != MPI_WIN_NULL) MPI_Win_free(&_window);
+    }
+
+    [[nodiscard]] std::span<const T> view() const { return {_data, _size}; }
+
+    [[nodiscard]] std::size_t size() const { return _size; }
+  };
+
+#endif
+}  // namespace sqsgen::io::mpi
+
+#endif  // SQSGEN_IO_MPI_SHARED_H
@@ -0,0 +1,538 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_IO_PACK_H
+#define SQSGEN_IO_PACK_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <variant>
+
+#include "sqsgen/core/helpers/mapped_file.h"
+#include "sqsgen/core/results.h"
+#include "sqsgen/io/json.h"
+#include "sqsgen/log.h"
+
+namespace sqsgen::io {
+
+  using sqs_result_pack_t = std::variant<core::sqs_result_pack<float, SUBLATTICE_MODE_SPLIT>,
+                                         core::sqs_result_pack<double, SUBLATTICE_MODE_SPLIT>,
+                                         core::sqs_result_pack<float, SUBLATTICE_MODE_INTERACT>,
+                                         core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>>;
+
+  namespace detail {
+
+    // "SQSPACK" on little-endian machines, the first byte is an integer in msgpack
+    static constexpr std::uint64_t PACK_MAGIC = 0x004b434150535153;
+    static constexpr std::uint32_t PACK_VERSION = 1;
+
+    /*
+     * All offsets are counted from the first byte of the pack, since the packs of the variants are
+     * nested into the file of the main pack. Each column starts at a multiple of eight bytes
+     */
+    struct pack_header {
+      std::uint64_t magic{PACK_MAGIC};
+      std::uint32_t version{PACK_VERSION};
+      std::uint8_t value_size{};
+      std::uint8_t mode{};
+      std::uint16_t reserved{};
+      std::uint64_t num_results{};
+      std::uint64_t num_sublattices{};
+      std::uint64_t num_objectives{};
+      std::uint64_t num_variants{};
+      // msgpack document holding the configuration and the statistics
+      std::uint64_t metadata_offset{};
+      std::uint64_t metadata_size{};
+      // num_results values of type T
+      std::uint64_t objective_offset{};
+      // num_objectives pack_index_entry, in ascending order of the objective
+      std::uint64_t index_offset{};
+      // num_sublattices pack_sublattice_header
+      std::uint64_t sublattice_offset{};
+      // num_variants pairs of offset and size
+      std::uint64_t variant_offset{};
+      std::uint64_t size{};
+    };
+
+    // the results with this objective are the rows [first, first + count)
+    struct pack_index_entry {
+      double objective;
+      std::uint64_t first;
+      std::uint64_t count;
+    };
+
+    /*
+     * The columns of a sublattice. In interact mode, the whole structure is the only sublattice. A
+     * compact result has no species, and the SRO parameters are not stored if they were not
+     * computed, hence each row has a presence flag for both
+     */
+    struct pack_sublattice_header {
+      std::uint64_t num_sites{};
+      std::array<std::uint64_t, 3> sro_shape{};
+      // num_results values of type T
+      std::uint64_t objective_offset{};
+      // num_results values of type std::uint64_t
+      std::uint64_t iteration_offset{};
+      // num_results flags, followed by a num_results x num_sites matrix of std::uint8_t
+      std::uint64_t species_mask_offset{};
+      std::uint64_t species_offset{};
+      // num_results flags, followed by num_results SRO cubes of type T
+      std::uint64_t sro_mask_offset{};
+      std::uint64_t sro_offset{};
+    };
+
+    class pack_writer {
+      std::ostream& _out;
+      std::streamoff _base;
+
+    public:
+      explicit pack_writer(std::ostream& out) : _out(out), _base(out.tellp()) {}
+
+      [[nodiscard]] std::uint64_t tell() const {
+        return static_cast<std::uint64_t>(_out.tellp() - _base);
+      }
+
+      std::uint64_t align() {
+        static constexpr char zeros[8]{};
+        auto offset = tell();
+        if (auto rest = offset % 8; rest != 0) {
+          _out.write(zeros, static_cast<std::streamsize>(8 - rest));
+          offset += 8 - rest;
+        }
+        return offset;
+      }
+
+      template <class V>
+        requires std::is_trivially_copyable_v<V>
+      void put(V const& value) {
+        _out.write(reinterpret_cast<const char*>(&value), sizeof(V));
+      }
+
+      void put_bytes(const void* data, std::size_t size) {
+        _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+      }
+
+      // overwrites the bytes at offset, and returns to the end of the pack
+      template <class V> void patch(std::uint64_t offset, V const& value) {
+        auto end = _out.tellp();
+        _out.seekp(_base + static_cast<std::streamoff>(offset));
+        put(value);
+        _out.seekp(end);
+      }
+    };
+
+    template <class T, SublatticeMode Mode>
+    sqs_result<T, SUBLATTICE_MODE_INTERACT> const& sublattice_of(
+        core::detail::sqs_result_wrapper<T, Mode> const& row, std::size_t sublattice) {
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        return row;
+      else
+        return row.sublattices[sublattice];
+    }
+
+    template <class T, SublatticeMode Mode, class Fn>
+    void for_each_row(core::sqs_result_pack<T, Mode> const& pack, Fn&& fn) {
+      for (auto const& [_, rows] : pack.results)
+        for (auto const& row : rows) fn(row);
+    }
+
+    template <class T, SublatticeMode Mode>
+    pack_sublattice_header write_sublattice(pack_writer& writer,
+                                            core::sqs_result_pack<T, Mode> const& pack,
+                                            std::size_t sublattice) {
+      pack_sublattice_header header;
+      bool shaped{false};
+      for_each_row(pack, [&](auto const& row) {
+        auto const& r = sublattice_of(row, sublattice);
+        if (!r.compact())
+          header.num_sites = std::max<std::uint64_t>(header.num_sites, r.species.size());
+        if (r.sro.size() > 0 && !shaped) {
+          auto const& d = r.sro.dimensions();
+          header.sro_shape = {static_cast<std::uint64_t>(d[0]), static_cast<std::uint64_t>(d[1]),
+                              static_cast<std::uint64_t>(d[2])};
+          shaped = true;
+        }
+      });
+      auto sro_size = header.sro_shape[0] * header.sro_shape[1] * header.sro_shape[2];
+
+      header.objective_offset = writer.align();
+      for_each_row(pack,
+                   [&](auto const& row) { writer.put(sublattice_of(row, sublattice).objective); });
+      header.iteration_offset = writer.align();
+      for_each_row(pack, [&](auto const& row) {
+        writer.put(static_cast<std::uint64_t>(sublattice_of(row, sublattice).iteration));
+      });
+      header.species_mask_offset = writer.align();
+      for_each_row(pack, [&](auto const& row) {
+        writer.put(static_cast<std::uint8_t>(!sublattice_of(row, sublattice).compact()));
+      });
+      header.species_offset = writer.align();
+      std::vector<std::uint8_t> species(header.num_sites);
+      for_each_row(pack, [&](auto const& row) {
+        auto const& r = sublattice_of(row, sublattice);
+        if (!r.compact() && r.species.size() != header.num_sites)
+          throw std::invalid_argument("All results of a pack must have the same number of sites");
+        for (std::size_t i = 0; i < species.size(); ++i)
+          species[i] = r.compact() ? 0 : static_cast<std::uint8_t>(r.species[i]);
+        writer.put_bytes(species.data(), species.size());
+      });
+      header.sro_mask_offset = writer.align();
+      for_each_row(pack, [&](auto const& row) {
+        writer.put(static_cast<std::uint8_t>(sublattice_of(row, sublattice).sro.size() > 0));
+      });
+      header.sro_offset = writer.align();
+      std::vector<T> zeros(sro_size);
+      for_each_row(pack, [&](auto const& row) {
+        auto const& r = sublattice_of(row, sublattice);
+        if (r.sro.size() == 0)
+          writer.put_bytes(zeros.data(), zeros.size() * sizeof(T));
+        else if (static_cast<std::uint64_t>(r.sro.size()) != sro_size)
+          throw std::invalid_argument("All results of a pack must have the same SRO shape");
+        else
+          writer.put_bytes(r.sro.data(), sro_size * sizeof(T));
+      });
+      return header;
+    }
+
+    template <class T, SublatticeMode Mode>
+    std::uint64_t write_pack(std::ostream& out, core::sqs_result_pack<T, Mode> const& pack) {
+      pack_writer writer(out);
+      pack_header header;
+      header.value_size = sizeof(T);
+      header.mode = static_cast<std::uint8_t>(Mode);
+      header.num_variants = pack.variants.size();
+      for (auto const& [_, rows] : pack.results) {
+        header.num_results += rows.size();
+        ++header.num_objectives;
+      }
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        header.num_sublattices = 1;
+      else
+        header.num_sublattices = pack.config.composition.size();
+      writer.put(header);
+
+      header.metadata_offset = writer.align();
+      {
+        auto metadata = nlohmann::json::to_msgpack(
+            nlohmann::json{{"config", pack.config}, {"statistics", pack.statistics}});
+        header.metadata_size = metadata.size();
+        writer.put_bytes(metadata.data(), metadata.size());
+      }
+
+      header.objective_offset = writer.align();
+      for_each_row(pack, [&](auto const& row) { writer.put(row.objective); });
+
+      header.index_offset = writer.align();
+      std::uint64_t first{0};
+      for (auto const& [objective, rows] : pack.results) {
+        writer.put(pack_index_entry{static_cast<double>(objective), first, rows.size()});
+        first += rows.size();
+      }
+
+      std::vector<pack_sublattice_header> sublattices;
+      sublattices.reserve(header.num_sublattices);
+      for (std::size_t s = 0; s < header.num_sublattices; ++s)
+        sublattices.push_back(write_sublattice(writer, pack, s));
+      header.sublattice_offset = writer.align();
+      for (auto const& sublattice : sublattices) writer.put(sublattice);
+
+      std::vector<std::array<std::uint64_t, 2>> variants;
+      for (auto const& variant : pack.variants) {
+        auto offset = writer.align();
+        variants.push_back({offset, write_pack(out, variant)});
+      }
+      header.variant_offset = writer.align();
+      for (auto const& variant : variants) writer.put(variant);
+
+      header.size = writer.tell();
+      writer.patch(0, header);
+      if (!out.good()) throw std::runtime_error("Failed to write the result pack");
+      return header.size;
+    }
+
+  }  // namespace detail
+
+  /*
+   * Random access to a pack written by write_pack. Nothing but the header is decoded up front, a
+   * result is only read from its columns when it is requested. The optimization config needed to
+   * restore a result is built on the first access and shared by all results of the view. The bytes
+   * are usually a mapping of the file, see open_pack
+   */
+  template <class T, SublatticeMode Mode> class pack_view {
+    using result_t = core::detail::sqs_result_wrapper<T, Mode>;
+
+    struct context {
+      std::shared_ptr<core::structure<T>> structure;
+      core::detail::opt_config_t<T, Mode> opt_config;
+      decltype(core::detail::replay_keys<T, Mode>(std::declval<core::configuration<T>>())) keys;
+    };
+
+    // decoded on first use, shared by the copies of a view
+    struct lazy {
+      std::once_flag config_flag;
+      std::once_flag context_flag;
+      std::optional<core::configuration<T>> config;
+      std::optional<context> ctx;
+    };
+
+    std::shared_ptr<const void> _owner;
+    std::span<const std::byte> _bytes;
+    detail::pack_header _header;
+    std::vector<detail::pack_sublattice_header> _sublattices;
+    std::shared_ptr<lazy> _lazy = std::make_shared<lazy>();
+
+    template <class V> V load(std::uint64_t offset) const {
+      if (offset > _bytes.size() || _bytes.size() - offset < sizeof(V))
+        throw std::out_of_range("Truncated result pack");
+      V value;
+      std::memcpy(&value, _bytes.data() + offset, sizeof(V));
+      return value;
+    }
+
+    std::span<const std::byte> slice(std::uint64_t offset, std::uint64_t size) const {
+      if (offset > _bytes.size() || _bytes.size() - offset < size)
+        throw std::out_of_range("Truncated result pack");
+      return _bytes.subspan(offset, size);
+    }
+
+    [[nodiscard]] detail::pack_index_entry entry(std::size_t objective) const {
+      if (objective >= _header.num_objectives) throw std::out_of_range("Objective out of range");
+      return load<detail::pack_index_entry>(_header.index_offset
+                                            + objective * sizeof(detail::pack_index_entry));
+    }
+
+    sqs_result<T, SUBLATTICE_MODE_INTERACT> sublattice_row(std::size_t sublattice,
+                                                           std::uint64_t row) const {
+      auto const& h = _sublattices[sublattice];
+      sqs_result<T, SUBLATTICE_MODE_INTERACT> result;
+      result.objective = load<T>(h.objective_offset + row * sizeof(T));
+      result.iteration = static_cast<iterations_t>(
+          load<std::uint64_t>(h.iteration_offset + row * sizeof(std::uint64_t)));
+      if (load<std::uint8_t>(h.species_mask_offset + row) != 0) {
+        auto bytes = slice(h.species_offset + row * h.num_sites, h.num_sites);
+        configuration_t species(h.num_sites);
+        std::ranges::transform(bytes, species.begin(),
+                               [](auto b) { return static_cast<specie_t>(b); });
+        result.species = packed_configuration_t(species);
+      }
+      if (load<std::uint8_t>(h.sro_mask_offset + row) != 0) {
+        auto [a, b, c] = h.sro_shape;
+        cube_t<T> sro(a, b, c);
+        auto bytes = slice(h.sro_offset + row * a * b * c * sizeof(T), a * b * c * sizeof(T));
+        std::memcpy(sro.data(), bytes.data(), bytes.size());
+        result.sro = std::move(sro);
+      }
+      return result;
+    }
+
+    context const& restore_context() const {
+      std::call_once(_lazy->context_flag, [this] {
+        auto const& config = this->config();
+        _lazy->ctx = context{
+            std::make_shared<core::structure<T>>(config.structure.structure()),
+            core::detail::from_opt_config<T, Mode>(
+                core::detail::opt_config_from_config<T, Mode>(core::configuration<T>{config})),
+            core::detail::replay_keys<T, Mode>(config)};
+      });
+      return _lazy->ctx.value();
+    }
+
+  public:
+    pack_view(std::shared_ptr<const void> owner, std::span<const std::byte> bytes)
+        : _owner(std::move(owner)), _bytes(bytes), _header(load<detail::pack_header>(0)) {
+      if (_header.magic != detail::PACK_MAGIC)
+        throw std::invalid_argument("Not a columnar sqsgen result pack");
+      if (_header.version != detail::PACK_VERSION)
+        throw std::invalid_argument(
+            format_string("Unsupported result pack version %i", _header.version));
+      if (_header.value_size != sizeof(T) || _header.mode != static_cast<std::uint8_t>(Mode))
+        throw std::invalid_argument("The result pack has a different precision or mode");
+      if (_header.size > _bytes.size()) throw std::out_of_range("Truncated result pack");
+      _bytes = _bytes.first(_header.size);
+      for (std::size_t s = 0; s < _header.num_sublattices; ++s)
+        _sublattices.push_back(load<detail::pack_sublattice_header>(
+            _header.sublattice_offset + s * sizeof(detail::pack_sublattice_header)));
+    }
+
+    core::configuration<T> const& config() const {
+      std::call_once(_lazy->config_flag, [this] {
+        auto metadata = slice(_header.metadata_offset, _header.metadata_size);
+        auto j = nlohmann::json::from_msgpack(
+            reinterpret_cast<const std::uint8_t*>(metadata.data()),
+            reinterpret_cast<const std::uint8_t*>(metadata.data()) + metadata.size());
+        _lazy->config = j.at("config").template get<core::configuration<T>>();
+      });
+      return _lazy->config.value();
+    }
+
+    [[nodiscard]] sqs_statistics_data<T> statistics() const {
+      auto metadata = slice(_header.metadata_offset, _header.metadata_size);
+      auto j = nlohmann::json::from_msgpack(
+          reinterpret_cast<const std::uint8_t*>(metadata.data()),
+          reinterpret_cast<const std::uint8_t*>(metadata.data()) + metadata.size());
+      return j.at("statistics").template get<sqs_statistics_data<T>>();
+    }
+
+    // the number of distinct objectives
+    [[nodiscard]] std::size_t size() const { return _header.num_objectives; }
+
+    [[nodiscard]] std::size_t num_results() const { return _header.num_results; }
+
+    [[nodiscard]] T objective(std::size_t objective) const {
+      return static_cast<T>(entry(objective).objective);
+    }
+
+    [[nodiscard]] std::size_t num_results(std::size_t objective) const {
+      return entry(objective).count;
+    }
+
+    // the result as it is stored, i.e. with the species of a compact result not yet restored
+    [[nodiscard]] sqs_result<T, Mode> raw(std::size_t objective, std::size_t index) const {
+      auto e = entry(objective);
+      if (index >= e.count) throw std::out_of_range("Result index out of range");
+      auto row = e.first + index;
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        return sublattice_row(0, row);
+      else {
+        std::vector<sqs_result<T, SUBLATTICE_MODE_INTERACT>> sublattices;
+        for (std::size_t s = 0; s < _sublattices.size(); ++s)
+          sublattices.push_back(sublattice_row(s, row));
+        return {load<T>(_header.objective_offset + row * sizeof(T)), std::move(sublattices)};
+      }
+    }
+
+    // may be called concurrently
+    result_t result(std::size_t objective, std::size_t index) const {
+      auto const& ctx = restore_context();
+      return result_t{raw(objective, index), ctx.structure, ctx.opt_config, ctx.keys};
+    }
+
+    std::vector<result_t> results(std::size_t objective) const {
+      std::vector<result_t> results;
+      results.reserve(num_results(objective));
+      for (std::size_t i = 0; i < num_results(objective); ++i)
+        results.push_back(result(objective, i));
+      return results;
+    }
+
+    [[nodiscard]] std::size_t num_variants() const { return _header.num_variants; }
+
+    [[nodiscard]] pack_view variant(std::size_t index) const {
+      if (index >= _header.num_variants) throw std::out_of_range("Variant index out of range");
+      auto [offset, size] = load<std::array<std::uint64_t, 2>>(
+          _header.variant_offset + index * sizeof(std::array<std::uint64_t, 2>));
+      return pack_view{_owner, slice(offset, size)};
+    }
+
+    // decodes all results, e.g. to rescore them
+    core::sqs_result_pack<T, Mode> load() const {
+      core::sqs_result_collection<T, Mode> results;
+      for (std::size_t o = 0; o < size(); ++o)
+        for (std::size_t i = 0; i < num_results(o); ++i) results.insert(raw(o, i));
+      auto const& config = this->config();
+      core::sqs_result_pack<T, Mode> pack{core::configuration<T>(config),
+                                          std::move(results.results()), statistics()};
+      pack.config = config;
+      for (std::size_t v = 0; v < num_variants(); ++v) pack.variants.push_back(variant(v).load());
+      return pack;
+    }
+  };
+
+  using pack_view_t = std::variant<pack_view<float, SUBLATTICE_MODE_SPLIT>,
+                                   pack_view<double, SUBLATTICE_MODE_SPLIT>,
+                                   pack_view<float, SUBLATTICE_MODE_INTERACT>,
+                                   pack_view<double, SUBLATTICE_MODE_INTERACT>>;
+
+  /*
+   * Writes a result pack column by column, straight from the result collection into the file.
+   * Unlike the msgpack serialization, no intermediate document of the results is built, thus the
+   * memory needed does not grow with the number of results
+   */
+  template <class T, SublatticeMode Mode>
+  std::uint64_t write_pack(std::ostream& out, core::sqs_result_pack<T, Mode> const& pack) {
+    return detail::write_pack(out, pack);
+  }
+
+  template <class T, SublatticeMode Mode>
+  void write_pack(std::filesystem::path const& path, core::sqs_result_pack<T, Mode> const& pack) {
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.good())
+      throw std::runtime_error(format_string("Cannot open output file \"%s\"", path.string()));
+    detail::write_pack(out, pack);
+  }
+
+  // whether in holds a pack written by write_pack, otherwise it is expected to be a msgpack document
+  inline bool is_columnar_pack(std::istream& in) {
+    auto position = in.tellg();
+    std::uint64_t magic{0};
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    auto columnar = in.good() && magic == detail::PACK_MAGIC;
+    in.clear();
+    in.seekg(position);
+    return columnar;
+  }
+
+  inline bool is_columnar_pack(std::filesystem::path const& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    return is_columnar_pack(in);
+  }
+
+  // a view of the pack held by bytes, owner keeps the memory alive
+  inline pack_view_t make_view(std::shared_ptr<const void> owner,
+                               std::span<const std::byte> bytes) {
+    detail::pack_header header;
+    if (bytes.size() < sizeof(header)) throw std::invalid_argument("Truncated result pack");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != detail::PACK_MAGIC)
+      throw std::invalid_argument("Not a columnar sqsgen result pack");
+    auto mode = static_cast<SublatticeMode>(header.mode);
+    if (header.value_size == sizeof(float) && mode == SUBLATTICE_MODE_SPLIT)
+      return pack_view<float, SUBLATTICE_MODE_SPLIT>(std::move(owner), bytes);
+    if (header.value_size == sizeof(double) && mode == SUBLATTICE_MODE_SPLIT)
+      return pack_view<double, SUBLATTICE_MODE_SPLIT>(std::move(owner), bytes);
+    if (header.value_size == sizeof(float) && mode == SUBLATTICE_MODE_INTERACT)
+      return pack_view<float, SUBLATTICE_MODE_INTERACT>(std::move(owner), bytes);
+    if (header.value_size == sizeof(double) && mode == SUBLATTICE_MODE_INTERACT)
+      return pack_view<double, SUBLATTICE_MODE_INTERACT>(std::move(owner), bytes);
+    throw std::invalid_argument("The result pack has an invalid precision or sublattice mode");
+  }
+
+  // a view of a pack which is already in memory, it is written into a buffer first
+  inline pack_view_t make_view(sqs_result_pack_t const& pack) {
+    std::ostringstream out(std::ios::out | std::ios::binary);
+    std::visit([&](auto const& p) { write_pack(out, p); }, pack);
+    auto buffer = std::make_shared<std::string>(std::move(out).str());
+    return make_view(buffer, std::as_bytes(std::span(buffer->data(), buffer->size())));
+  }
+
+  // maps the file written by write_pack into memory
+  inline pack_view_t open_pack(std::filesystem::path const& path) {
+    auto file = std::make_shared<core::helpers::mapped_file>(path);
+    return make_view(file, file->bytes());
+  }
+
+  inline sqs_result_pack_t read_pack(std::istream& in) {
+    auto buffer = std::make_shared<std::string>(std::istreambuf_iterator<char>(in),
+                                                std::istreambuf_iterator<char>{});
+    return std::visit([](auto&& view) -> sqs_result_pack_t { return view.load(); },
+                      make_view(buffer, std::as_bytes(std::span(buffer->data(), buffer->size()))));
+  }
+
+  inline sqs_result_pack_t read_pack(std::filesystem::path const& path) {
+    return std::visit([](auto&& view) -> sqs_result_pack_t { return view.load(); },
+                      open_pack(path));
+  }
+
+}  // namespace sqsgen::io
+
+#endif  // SQSGEN_IO_PACK_H
@@ -0,0 +1,156 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#ifndef SQSGEN_IO_SPILL_H
+#define SQSGEN_IO_SPILL_H
+
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+
+#include "sqsgen/core/helpers/bounded_queue.h"
+#include "sqsgen/io/json.h"
+#include "sqsgen/log.h"
+
+namespace sqsgen::io {
+
+  namespace detail {
+
+    static constexpr std::array<char, 8> SPILL_MAGIC{'S', 'Q', 'S', 'S', 'P', 'I', 'L', 'L'};
+    // the number of results which may wait for the writer, before the workers are blocked
+    static constexpr std::size_t SPILL_QUEUE_SIZE = 1024;
+
+    inline void check_spill_magic(std::istream& in, std::filesystem::path const& path) {
+      std::array<char, SPILL_MAGIC.size()> magic{};
+      in.read(magic.data(), magic.size());
+      if (!in.good() || magic != SPILL_MAGIC)
+        throw std::invalid_argument(
+            format_string("\"%s\" is not a valid sqsgen spill file", path.string()));
+    }
+
+    // the size of the file up to the end of the last complete result
+    inline std::uintmax_t spill_size(std::filesystem::path const& path) {
+      std::ifstream in(path, std::ios::in | std::ios::binary);
+      check_spill_magic(in, path);
+      std::uintmax_t end{SPILL_MAGIC.size()}, file_size{std::filesystem::file_size(path)};
+      std::uint32_t size;
+      while (in.read(reinterpret_cast<char*>(&size), sizeof(size))
+             && end + sizeof(size) + size <= file_size) {
+        end += sizeof(size) + size;
+        in.seekg(size, std::ios::cur);
+      }
+      return end;
+    }
+
+  }  // namespace detail
+
+  /*
+   * An append-only file of results. The results are handed over through a bounded queue and
+   * written by a background thread, hence the workers only block if the writer falls behind.
+   * Each result is stored as its msgpack representation, prefixed by its size
+   */
+  template <class T, SublatticeMode Mode> class spill_sink {
+    using result_t = sqs_result<T, Mode>;
+
+    std::filesystem::path _path;
+    std::ofstream _out;
+    core::helpers::bounded_queue<result_t> _queue;
+    std::exception_ptr _error;
+    std::size_t _written{0};
+    std::thread _writer;
+
+    void write() {
+      try {
+        while (auto result = _queue.pop()) {
+          auto bytes = nlohmann::json::to_msgpack(nlohmann::json(result.value()));
+          auto size = static_cast<std::uint32_t>(bytes.size());
+          _out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+          _out.write(reinterpret_cast<const char*>(bytes.data()), size);
+          // the results are persisted as soon as the writer has caught up
+          if (_queue.empty()) _out.flush();
+          if (!_out.good())
+            throw std::runtime_error(
+                format_string("Failed to write spill file \"%s\"", _path.string()));
+          ++_written;
+        }
+        _out.flush();
+      } catch (...) {
+        _error = std::current_exception();
+        // the workers must not block on a queue which is never drained
+        _queue.close();
+      }
+    }
+
+    void join() {
+      if (!_writer.joinable()) return;
+      _queue.close();
+      _writer.join();
+    }
+
+  public:
+    /*
+     * If append is set, the results are appended to an existing file, e.g. when resuming a run.
+     * An incomplete result at its end, left by a killed job, is cut off
+     */
+    spill_sink(std::filesystem::path path, bool append,
+               std::size_t capacity = detail::SPILL_QUEUE_SIZE)
+        : _path(std::move(path)), _queue(capacity) {
+      append = append && std::filesystem::exists(_path);
+      if (append) std::filesystem::resize_file(_path, detail::spill_size(_path));
+      _out.open(_path,
+                std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+      if (!_out.good())
+        throw std::runtime_error(format_string("Cannot open spill file \"%s\"", _path.string()));
+      if (!append) _out.write(detail::SPILL_MAGIC.data(), detail::SPILL_MAGIC.size());
+      _writer = std::thread([this] { write(); });
+    }
+
+    spill_sink(spill_sink const&) = delete;
+    spill_sink& operator=(spill_sink const&) = delete;
+
+    ~spill_sink() { join(); }
+
+    // false if the writer has failed, close() reports the error then
+    bool push(result_t&& result) { return _queue.push(std::move(result)); }
+
+    // waits until all pending results are written and returns the number of written results
+    std::size_t close() {
+      join();
+      if (_error) std::rethrow_exception(_error);
+      return _written;
+    }
+
+    [[nodiscard]] std::filesystem::path const& path() const { return _path; }
+  };
+
+  // calls fn with each result of a spill file and returns the number of results read
+  template <class T, SublatticeMode Mode, class Fn>
+  std::size_t read_spill(std::filesystem::path const& path, Fn&& fn) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.good())
+      throw std::runtime_error(format_string("Cannot open spill file \"%s\"", path.string()));
+    detail::check_spill_magic(in, path);
+    std::size_t count{0};
+    std::uint32_t size;
+    std::vector<std::uint8_t> bytes;
+    while (in.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+      bytes.resize(size);
+      if (!in.read(reinterpret_cast<char*>(bytes.data()), size)) break;
+      fn(nlohmann::json::from_msgpack(bytes).get<sqs_result<T, Mode>>());
+      ++count;
+    }
+    if (in.gcount() > 0)
+      log::warn(format_string("Spill file \"%s\" ends with an incomplete result, which is ignored",
+                              path.string()));
+    return count;
+  }
+
+}  // namespace sqsgen::io
+
+#endif  // SQSGEN_IO_SPILL_H
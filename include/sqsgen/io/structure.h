@@ -614,6 +614,34 @@ namespace sqsgen::io {
     }
   };
 
+  // extended XYZ, the frames of several structures can simply be concatenated
+  template <class T> struct structure_adapter<T, STRUCTURE_FORMAT_XYZ> {
+    static std::string format(core::structure<T> const& structure) {
+      auto filtered = structure.without_vacancies();
+      std::string result;
+      result.reserve(filtered.size() * 80 + 256);
+
+      const auto println
+          = [&result](std::string const& line) { result.append(format_string("%s\n", line)); };
+      const auto pbc = [&](auto axis) { return filtered.pbc[axis] ? "T" : "F"; };
+      auto const& l = filtered.lattice;
+
+      println(format_string("%i", filtered.size()));
+      println(format_string(
+          "Lattice=\"%.16f %.16f %.16f %.16f %.16f %.16f %.16f %.16f %.16f\" "
+          "Properties=species:S:1:pos:R:3 pbc=\"%s %s %s\"",
+          l(0, 0), l(0, 1), l(0, 2), l(1, 0), l(1, 1), l(1, 2), l(2, 0), l(2, 1), l(2, 2), pbc(0),
+          pbc(1), pbc(2)));
+      for (std::size_t i = 0; i < filtered.size(); ++i) {
+        Eigen::Vector3<T> position = filtered.frac_coords.row(i) * filtered.lattice;
+        println(format_string("%-2s %23.16f %23.16f %23.16f",
+                              core::atom::from_z(filtered.species[i]).symbol, position(0),
+                              position(1), position(2)));
+      }
+      return result;
+    }
+  };
+
   template <class T>
   std::string format(core::structure<T> const& structure, StructureFormat format) {
     switch (format) {
@@ -629,6 +657,8 @@ namespace sqsgen::io {
         return structure_adapter<T, STRUCTURE_FORMAT_JSON_SQSGEN>::format(structure);
       case STRUCTURE_FORMAT_PDB:
         return structure_adapter<T, STRUCTURE_FORMAT_PDB>::format(structure);
+      case STRUCTURE_FORMAT_XYZ:
+        return structure_adapter<T, STRUCTURE_FORMAT_XYZ>::format(structure);
     }
     throw std::invalid_argument("invalid structure format");
   }
@@ -9,16 +9,23 @@
 #include <atomic>
 #include <csignal>
 #include <iostream>
+#include <set>
+#include <span>
 #include <thread>
 
+#include "sqsgen/core/checkpoint.h"
 #include "sqsgen/core/config.h"
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/core/optimization.h"
 #include "sqsgen/core/optimization_config.h"
 #include "sqsgen/core/results.h"
 #include "sqsgen/core/shuffle.h"
 #include "sqsgen/core/statistics.h"
+#include "sqsgen/core/symmetry.h"
+#include "sqsgen/io/checkpoint.h"
 #include "sqsgen/io/mpi.h"
+#include "sqsgen/io/spill.h"
 #include "sqsgen/types.h"
 
 #ifdef _WIN32
@@ -88,33 +95,31 @@ namespace sqsgen {
     namespace ranges = std::ranges;
     namespace views = ranges::views;
 
+    // number of iterations after which a worker evaluates the stopping rules
+    constexpr iterations_t STOP_RULE_INTERVAL = 1024;
+
+    using thread_pool_t = BS::thread_pool<BS::tp::pause>;
+
     template <class T, SublatticeMode Mode> using lift_t
         = std::conditional_t<Mode == SUBLATTICE_MODE_INTERACT, T, std::vector<T>>;
 
     template <class T, SublatticeMode Mode>
     sqs_result<T, Mode> postprocess_results(sqs_result<T, Mode>& r,
                                             std::vector<optimization_config<T, Mode>>& configs) {
-      const auto restore_order
-          = [&](configuration_t& species,
-                optimization_config<T, Mode> const& config) -> configuration_t {
-        auto sorted = as<std::vector>{}(config.sort_order | views::transform([&](auto&& index) {
-                                          return config.species_map.second.at(species[index]);
-                                        }));
-        configuration_t reversed(species.size());
-        for (auto i = 0; i < species.size(); i++)
-          reversed[config.sort_order[i]] = config.species_map.second.at(species[i]);
-
-        return reversed;
-      };
+      // compact results are regenerated in the order of the input structure anyway
       if constexpr (Mode == SUBLATTICE_MODE_INTERACT) {
-        r.species = restore_order(r.species, configs.front());
+        if (!r.compact())
+          r.species = packed_configuration_t(
+              core::detail::restore_order<T>(r.species.unpack(), configs.front()));
         return r;
       }
       if constexpr (Mode == SUBLATTICE_MODE_SPLIT) {
         assert(configs.size() == r.sublattices.size());
         for_each(
             [&](auto&& i) {
-              r.sublattices[i].species = restore_order(r.sublattices[i].species, configs[i]);
+              if (!r.sublattices[i].compact())
+                r.sublattices[i].species = packed_configuration_t(
+                    core::detail::restore_order<T>(r.sublattices[i].species.unpack(), configs[i]));
             },
             range(configs.size()));
         return r;
@@ -146,17 +151,33 @@ namespace sqsgen {
   template <class T, SublatticeMode Mode> struct optimizer_base {
 #ifdef WITH_MPI
     mpl::communicator comm;
+    // only set if the pair lists are shared between the ranks of a node
+    std::unique_ptr<io::mpi::node_communicator> _node;
+    std::vector<io::mpi::shared_array<core::packed_pair>> _shared_pairs;
 #endif
     std::atomic<T> _best_objective;
     std::atomic<T> _search_objective;
     thread_config_t _thread_config;
     std::map<std::thread::id, int> _thread_map;
     std::mutex _thread_map_mutex;
+    // created on first use, unless it is shared with other optimizers
+    std::shared_ptr<detail::thread_pool_t> _pool;
 
   protected:
     core::configuration<T> config;
     core::sqs_result_collection<T, Mode> results;
+    // the results and search objective of each variant of the objective function
+    std::vector<core::sqs_result_collection<T, Mode>> variant_results;
+    std::vector<std::atomic<T>> _variant_search_objective;
     std::vector<core::optimization_config<T, Mode>> opt_configs;
+    std::vector<std::span<const core::packed_pair>> _pairs;
+    core::canonicalizer _canonicalizer;
+    // state carried over from a checkpoint, see optimizer::restore
+    std::optional<sqs_statistics_data<T>> _resumed_statistics;
+    std::vector<bounds_t<iterations_t>> _resumed_chunks;
+    // receives the accepted results while the run is going on, if config.spill is set
+    std::unique_ptr<io::spill_sink<T, Mode>> _spill;
+    std::atomic<std::size_t> _held{0};
 
     int thread_id() {
       std::unique_lock lock(_thread_map_mutex);
@@ -213,6 +234,17 @@ namespace sqsgen {
       if (objective < _search_objective.load()) _search_objective.store(objective);
     }
 
+    T variant_search_objective(std::size_t variant) {
+      return _variant_search_objective[variant].load();
+    }
+
+    detail::thread_pool_t& thread_pool() {
+      if (!_pool) _pool = std::make_shared<detail::thread_pool_t>(num_threads());
+      // a shared pool is left paused if the previous optimizer was stopped
+      if (_pool->is_paused()) _pool->unpause();
+      return *_pool;
+    }
+
     [[nodiscard]] usize_t num_threads() {
       if (_thread_config.size() == 1) return _thread_config.front();
       if (_thread_config.size() != num_ranks())
@@ -249,7 +281,24 @@ namespace sqsgen {
       throw std::invalid_argument("unrecognized operation");
     }
 
-    explicit optimizer_base(core::configuration<T>&& config
+    // in shared memory mode, only the leader of a node computes the pair lists
+    [[nodiscard]] bool computes_pairs() const {
+#ifdef WITH_MPI
+      return !_node || _node->is_leader();
+#else
+      return true;
+#endif
+    }
+
+    sqsgen::detail::lift_t<std::span<const core::packed_pair>, Mode> pair_lists() {
+      if constexpr (Mode == SUBLATTICE_MODE_INTERACT)
+        return _pairs.front();
+      else
+        return _pairs;
+    }
+
+    explicit optimizer_base(core::configuration<T>&& config,
+                            core::geometry_cache<T>* geometry = nullptr
 #ifdef WITH_MPI
                             ,
                             mpl::communicator comm = mpl::environment::comm_world()
@@ -259,14 +308,85 @@ namespace sqsgen {
           _best_objective(std::numeric_limits<T>::max()),
           _search_objective(std::numeric_limits<T>::max()),
           results(),
+          variant_results(config.variants.size()),
+          _variant_search_objective(config.variants.size()),
 #ifdef WITH_MPI
           comm(comm),
+          _node(config.shared_memory && comm.size() > 1
+                    ? std::make_unique<io::mpi::node_communicator>(comm)
+                    : nullptr),
 #endif
           _thread_config(config.thread_config),
-          opt_configs(core::optimization_config<T, Mode>::from_config(config)) {
+          opt_configs(core::optimization_config<T, Mode>::from_config(config, computes_pairs(),
+                                                                      geometry)),
+          _canonicalizer(core::canonicalizer::from_config(config, opt_configs)) {
+      // the pair lists are owned by the optimization configs now
+      this->config.geometry.reset();
+      for (auto& search : _variant_search_objective) search.store(std::numeric_limits<T>::max());
+      if (!_canonicalizer.empty())
+        log::info(format_string("[Rank %i] results are deduplicated under %i site permutations",
+                                rank(), _canonicalizer.size()));
+#ifdef WITH_MPI
+      // all ranks draw from the streams of the head rank, since the configuration of an iteration
+      // must not depend on the rank which evaluates it
+      for (auto& c : opt_configs) {
+        std::uint64_t state{c.shuffler.state()};
+        MPI_Bcast(&state, 1, MPI_UINT64_T, io::mpi::RANK_HEAD, comm.native_handle());
+        c.shuffler.set_state(state);
+      }
+      if (_node) {
+        for (auto& c : opt_configs) {
+          _shared_pairs.emplace_back(*_node, c.pairs);
+          // the static bonds were counted along with the pairs on the leader
+          MPI_Bcast(c.static_bonds.data(),
+                    static_cast<int>(c.static_bonds.size() * sizeof(usize_t)), MPI_BYTE, 0,
+                    _node->native_handle());
+          std::vector<core::packed_pair>{}.swap(c.pairs);
+          _pairs.push_back(_shared_pairs.back().view());
+        }
+        log::info(format_string("[Rank %i] mapped %i pair lists from node-shared memory",
+                                comm.rank(), _shared_pairs.size()));
+        return;
+      }
+#endif
+      for (auto& c : opt_configs) _pairs.emplace_back(c.pairs);
+    }
+
+    void insert_result(sqs_result<T, Mode>&& result) {
+      if (!_spill) {
+        results.insert(std::move(result));
+        return;
+      }
+      auto spilled{result};
+      if (!results.insert(std::move(result))) return;
+      // a failed writer is reported once the run has finished
+      _spill->push(std::move(spilled));
+      // the results are on disk, the collection only needs to remember their objectives
+      if (_held.fetch_add(1) + 1 >= config.spill_limit) {
+        _held.store(0);
+        results.evict();
+      }
+    }
+
+    // the same rules as for the main objective apply, apart from the stopping rules
+    void insert_variant_result(std::size_t variant, sqs_result<T, Mode>&& result, std::size_t keep,
+                               std::optional<std::size_t> max_results_per_objective) {
+      auto& collection = variant_results[variant];
+      if (result.objective > variant_search_objective(variant)) return;
+      if (max_results_per_objective.has_value()
+          && collection.results_for_objective(result.objective) > max_results_per_objective.value())
+        return;
+      collection.insert(std::move(result));
+      auto search = collection.nth_best(keep);
+      if (search < _variant_search_objective[variant].load())
+        _variant_search_objective[variant].store(search);
     }
 
-    void insert_result(sqs_result<T, Mode>&& result) { results.insert(std::move(result)); }
+    // the representative of the configuration under the deduplication group
+    template <class Configuration> Configuration canonical(Configuration configuration) const {
+      _canonicalizer.canonicalize(configuration);
+      return configuration;
+    }
 
     auto results_for_objective(T objective) {
       return results.results_for_objective(objective);
@@ -275,17 +395,20 @@ namespace sqsgen {
 
     auto nth_best_objective(auto n) { return results.nth_best(n); }
 
+    // the SRO parameters of a result are recomputed on access, compact results do not carry
+    // species either. Hence, the shape is empty in both dimensions
     sqs_result<T, Mode> make_empty_result() {
       using namespace sqsgen::core::helpers;
+      const usize_t scale = config.compact_results ? 0 : 1;
       if constexpr (Mode == SUBLATTICE_MODE_INTERACT) {
-        auto c = opt_configs.front();
-        return core::sqs_result_factory<T, Mode>::empty(c.structure.size(), c.shell_weights.size(),
-                                                        c.sorted.num_species);
+        return core::sqs_result_factory<T, Mode>::empty(
+            scale * opt_configs.front().structure.size(), 0, 0);
       } else if constexpr (Mode == SUBLATTICE_MODE_SPLIT) {
         return core::sqs_result_factory<T, Mode>::empty(
-            opt_configs | views::transform([](auto&& c) { return c.species_packed.size(); }),
-            opt_configs | views::transform([](auto&& c) { return c.shell_weights.size(); }),
-            opt_configs | views::transform([](auto&& c) { return c.sorted.num_species; }));
+            opt_configs
+                | views::transform([&](auto&& c) { return scale * c.species_packed.size(); }),
+            opt_configs | views::transform([](auto&&) { return usize_t{0}; }),
+            opt_configs | views::transform([](auto&&) { return usize_t{0}; }));
       }
       throw std::invalid_argument("invalid lattice mode");
     }
@@ -294,8 +417,47 @@ namespace sqsgen {
   template <class T, IterationMode IMode, SublatticeMode SMode> class optimizer
       : public optimizer_base<T, SMode> {
   public:
-    explicit optimizer(core::configuration<T>&& config)
-        : optimizer_base<T, SMode>(std::forward<core::configuration<T>>(config)) {}
+    explicit optimizer(core::configuration<T>&& config,
+                       core::geometry_cache<T>* geometry = nullptr)
+        : optimizer_base<T, SMode>(std::forward<core::configuration<T>>(config), geometry) {}
+
+    // the workers are scheduled on pool, instead of a pool of their own
+    void share_pool(std::shared_ptr<detail::thread_pool_t> pool) { this->_pool = std::move(pool); }
+
+    std::shared_ptr<detail::thread_pool_t> shared_pool() const { return this->_pool; }
+
+    /*
+     * Continue from a checkpoint written by a previous run. The optimizer must have been
+     * constructed from the configuration stored in the checkpoint, chunks which were already
+     * evaluated completely are skipped
+     */
+    void restore(core::sqs_checkpoint<T, SMode>&& checkpoint) {
+      if (checkpoint.rng_state.size() != this->opt_configs.size())
+        throw std::invalid_argument(
+            format_string("The checkpoint contains %i random number generator states, but %i are "
+                          "required",
+                          checkpoint.rng_state.size(), this->opt_configs.size()));
+      for (auto i = 0; i < this->opt_configs.size(); ++i)
+        this->opt_configs[i].shuffler.set_state(checkpoint.rng_state[i]);
+      auto keep = this->config.keep;
+      for (auto&& result : checkpoint.results) {
+        auto objective_value = result.objective;
+        this->insert_result(std::move(result));
+        this->update_objectives({objective_value, this->nth_best_objective(keep)});
+      }
+      if (checkpoint.variant_results.size() != this->variant_results.size())
+        throw std::invalid_argument(
+            format_string("The checkpoint contains results of %i objective variants, but %i are "
+                          "configured",
+                          checkpoint.variant_results.size(), this->variant_results.size()));
+      for (auto v = 0; v < checkpoint.variant_results.size(); ++v)
+        for (auto&& result : checkpoint.variant_results[v])
+          this->insert_variant_result(v, std::move(result), keep,
+                                      this->config.max_results_per_objective);
+      checkpoint.statistics.working = 0;
+      this->_resumed_statistics = std::move(checkpoint.statistics);
+      this->_resumed_chunks = std::move(checkpoint.finished);
+    }
     auto run(log::level level = log::level::info,
              std::optional<sqs_callback_t> callback = std::nullopt) {
       using namespace sqsgen::core::helpers;
@@ -313,7 +475,9 @@ namespace sqsgen {
       log::info(format_string("[Rank %i] start=%s, end=%s", this->rank(), start.str(), end.str()));
 
       auto num_sublattices = this->opt_configs.size();
-      auto pairs{this->transpose_setting([](auto&& c) { return c.pairs; })};
+      auto pairs{this->pair_lists()};
+      auto periodic_pairs{this->transpose_setting([](auto&& c) { return c.periodic_pairs; })};
+      auto static_bonds{this->transpose_setting([](auto&& c) { return c.static_bonds; })};
       auto prefactors{this->transpose_setting([](auto&& c) { return c.prefactors; })};
       auto pair_weights{this->transpose_setting([](auto&& c) { return c.pair_weights; })};
       auto target_objective{this->transpose_setting([](auto&& c) { return c.target_objective; })};
@@ -321,10 +485,28 @@ namespace sqsgen {
       auto species_packed{this->transpose_setting([](auto&& c) { return c.species_packed; })};
       auto num_shells{this->transpose_setting([](auto&& c) { return c.shell_weights.size(); })};
       auto num_species{this->transpose_setting([](auto&& c) { return c.sorted.num_species; })};
+      // the prefactors, pair weights and target objective of each variant
+      const auto lift = [](std::vector<cube_t<T>> const& values) {
+        if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+          return values.front();
+        else
+          return values;
+      };
+      auto variants = as<std::vector>{}(this->config.variants | views::transform([&](auto&& v) {
+                                          return std::make_tuple(lift(v.prefactors),
+                                                                 lift(v.pair_weights),
+                                                                 lift(v.target_objective));
+                                        }));
+      auto num_variants = variants.size();
 
       auto keep = this->config.keep;
+      auto max_results_per_objective = this->config.max_results_per_objective;
+      auto compact_results = this->config.compact_results;
 
       core::sqs_statistics<T> statistics;
+      auto resumed = this->_resumed_statistics.has_value();
+      if (this->_resumed_statistics.has_value())
+        statistics.merge(std::move(this->_resumed_statistics.value()));
       auto stop_source = std::make_shared<std::stop_source>();
 
       std::shared_ptr<sqs_callback_t> callback_ptr;
@@ -333,7 +515,7 @@ namespace sqsgen {
       std::mutex setup_mutex;
       auto stop = stop_source->get_token();
 
-      BS::thread_pool<BS::tp::pause> pool(this->num_threads());
+      auto& pool = this->thread_pool();
 
       std::atomic<bool> thread_pool_purged{false};
       const auto purge = [&pool, &thread_pool_purged, this](auto thread_id) {
@@ -345,16 +527,53 @@ namespace sqsgen {
           pool.purge();
         }
       };
-      const auto worker = [this, &shuffler, &species_packed, &pairs, &prefactors, &target_objective,
-                           &pair_weights, &statistics, &purge, start, num_shells, num_species,
-                           stop_source, num_sublattices, keep, mpi_mode, callback_ptr, stop,
-                           max_results_per_objective = this->config.max_results_per_objective](
-                              rank_t rstart, rank_t rend) {
+      // stopping rules apart from the number of iterations. The workers evaluate the expensive
+      // ones (clock reads, atomics) only every STOP_RULE_INTERVAL iterations
+      auto max_time = this->config.max_time;
+      auto max_stagnation = this->config.max_stagnation;
+      auto objective_threshold = this->config.objective_threshold;
+      bool has_stop_rules = max_time.has_value() || max_stagnation.has_value();
+      auto started = std::chrono::steady_clock::now();
+      std::atomic<iterations_t> evaluated{0};
+      std::atomic<iterations_t> last_improvement{0};
+      const auto request_stop = [this, stop_source](std::string const& reason) {
+        if (stop_source->request_stop())
+          log::info(format_string("[Rank %i] stopping optimization: %s", this->rank(), reason));
+      };
+      const auto check_stop_rules = [&](iterations_t iterations) {
+        auto total = evaluated.fetch_add(iterations) + iterations;
+        if (max_time.has_value()
+            && std::chrono::steady_clock::now() - started
+                   >= std::chrono::seconds(max_time.value()))
+          request_stop(format_string("time budget of %is exhausted", max_time.value()));
+        if (max_stagnation.has_value() && total - last_improvement.load() >= max_stagnation.value())
+          request_stop(format_string("no improvement within the last %i iterations",
+                                     max_stagnation.value()));
+      };
+
+      // chunks which have been evaluated completely, these are skipped when resuming
+      std::set<bounds_t<iterations_t>> skip_chunks(this->_resumed_chunks.begin(),
+                                                   this->_resumed_chunks.end());
+      std::vector<bounds_t<iterations_t>> finished_chunks{this->_resumed_chunks};
+      std::mutex finished_chunks_mutex;
+
+      const auto worker = [this, &shuffler, &species_packed, &pairs, &periodic_pairs, &static_bonds,
+                           &prefactors, &target_objective, &pair_weights, &variants, &statistics,
+                           &purge, &skip_chunks, &finished_chunks, &finished_chunks_mutex,
+                           &check_stop_rules, &request_stop, &evaluated, &last_improvement, start,
+                           num_shells, num_species, stop_source, num_sublattices, num_variants,
+                           keep, mpi_mode, callback_ptr, stop, max_results_per_objective,
+                           has_stop_rules, max_stagnation, objective_threshold,
+                           compact_results](rank_t rstart, rank_t rend) {
         auto thread_id = this->thread_id();
         if (stop.stop_requested()) {
           purge(thread_id);
           return;
         }
+        bounds_t<iterations_t> chunk{static_cast<iterations_t>(rstart),
+                                     static_cast<iterations_t>(rend)};
+        if (skip_chunks.contains(chunk)) return;
+        bool completed{true};
         core::tick<TIMING_TOTAL> tick_total;
 
         log::debug(format_string("[Rank %i, Thread %i] received chunk start=%s, end=%s",
@@ -371,6 +590,7 @@ namespace sqsgen {
           return cube_t<T>(c.shell_weights.size(), c.sorted.num_species, c.sorted.num_species);
         })};
         auto objective = this->transpose_setting([](auto&&) { return T(0); });
+        auto variant_objective{objective};
         auto species{species_packed};
         statistics.add_working(iterations);
 
@@ -381,31 +601,52 @@ namespace sqsgen {
 
         core::tick<TIMING_LOOP> tick_loop;
 
-        for (auto i = rstart; i < rend; ++i) {
+        iterations_t since_check{0};
+        auto iteration = chunk.first;
+        for (auto i = rstart; i < rend; ++i, ++iteration) {
           if (!mpi_mode && signal::interrupted()) {
             log::info(format_string("[Rank %i, Thread %i] Process received SIGTERM or SIGINT ...",
                                     this->rank(), thread_id));
             stop_source->request_stop();
+            completed = false;
             break;
           }
           if (stop.stop_requested()) {
             log::info(format_string("[Rank %i, Thread %i] received stop signal ...", this->rank(),
                                     thread_id));
             purge(thread_id);
+            completed = false;
             break;
           }
+          if (has_stop_rules && ++since_check == sqsgen::detail::STOP_RULE_INTERVAL) {
+            check_stop_rules(since_check);
+            since_check = 0;
+          }
           if constexpr (SMode == SUBLATTICE_MODE_INTERACT) {
             if constexpr (IMode == ITERATION_MODE_SYSTEMATIC)
               assert(i + 1 == shuffler.rank_permutation(species));
-            optimization::count_bonds(bonds, pairs, species);
+            else
+              shuffler.shuffle(species, species_packed, iteration);
+            if (periodic_pairs.has_value())
+              optimization::count_bonds(bonds, periodic_pairs.value(), species, static_bonds);
+            else
+              optimization::count_bonds(bonds, pairs, species, static_bonds);
             objective = optimization::compute_objective(sro, bonds, prefactors, pair_weights,
                                                         target_objective, num_shells, num_species);
 
           } else if constexpr (SMode == SUBLATTICE_MODE_SPLIT) {
             std::vector<T> objectives(num_sublattices);
             for (auto sigma = 0; sigma < num_sublattices; ++sigma) {
-              shuffler.at(sigma).template shuffle<IMode>(species.at(sigma));
-              optimization::count_bonds(bonds.at(sigma), pairs.at(sigma), species.at(sigma));
+              if constexpr (IMode == ITERATION_MODE_RANDOM)
+                shuffler.at(sigma).shuffle(species.at(sigma), species_packed.at(sigma), iteration);
+              else
+                shuffler.at(sigma).template shuffle<IMode>(species.at(sigma));
+              if (periodic_pairs.at(sigma).has_value())
+                optimization::count_bonds(bonds.at(sigma), periodic_pairs.at(sigma).value(),
+                                          species.at(sigma), static_bonds.at(sigma));
+              else
+                optimization::count_bonds(bonds.at(sigma), pairs.at(sigma), species.at(sigma),
+                                          static_bonds.at(sigma));
               objective.at(sigma) = optimization::compute_objective(
                   sro.at(sigma), bonds.at(sigma), prefactors.at(sigma), pair_weights.at(sigma),
                   target_objective.at(sigma), num_shells.at(sigma), num_species.at(sigma));
@@ -417,6 +658,31 @@ namespace sqsgen {
           } else if constexpr (SMode == SUBLATTICE_MODE_SPLIT) {
             objective_value = sum(objective);
           }
+          // the bonds are scored once more under each variant of the objective function
+          for (auto v = 0; v < num_variants; ++v) {
+            auto const& [variant_prefactors, variant_pair_weights, variant_target] = variants[v];
+            T variant_value;
+            if constexpr (SMode == SUBLATTICE_MODE_INTERACT) {
+              variant_objective = optimization::compute_objective(
+                  sro, bonds, variant_prefactors, variant_pair_weights, variant_target, num_shells,
+                  num_species);
+              variant_value = variant_objective;
+            } else if constexpr (SMode == SUBLATTICE_MODE_SPLIT) {
+              for (auto sigma = 0; sigma < num_sublattices; ++sigma)
+                variant_objective.at(sigma) = optimization::compute_objective(
+                    sro.at(sigma), bonds.at(sigma), variant_prefactors.at(sigma),
+                    variant_pair_weights.at(sigma), variant_target.at(sigma), num_shells.at(sigma),
+                    num_species.at(sigma));
+              variant_value = sum(variant_objective);
+            }
+            if (variant_value > this->variant_search_objective(v)) continue;
+            this->insert_variant_result(
+                v,
+                compact_results ? sqs_result<T, SMode>(variant_value, variant_objective, iteration)
+                                : sqs_result<T, SMode>(variant_value, variant_objective,
+                                                       this->canonical(species), iteration),
+                keep, max_results_per_objective);
+          }
           // symmetrize bonds for each shell and compute objective function
           if (objective_value <= this->search_objective()) {
             // if the user limits the number of results found per objective we still might go on
@@ -425,24 +691,44 @@ namespace sqsgen {
                     > max_results_per_objective.value()))
               continue;
             // pull in changes from other ranks. Has another rank found a better
-            sqs_result<T, SMode> current(objective_value, objective, species, sro);
+            auto current
+                = compact_results
+                      ? sqs_result<T, SMode>(objective_value, objective, iteration)
+                      : sqs_result<T, SMode>(objective_value, objective, this->canonical(species),
+                                             iteration);
             log::debug(format_string(
                 "[Rank %i, Thread %i] found result with objective %.7f at iteration %s",
                 this->rank(), thread_id, objective_value, rank_t(rstart + i - start).str()));
+            // the keep-th best objective is infinite until keep objectives were found, hence an
+            // improvement of the best one counts as well
+            auto best = max_stagnation.has_value() ? this->nth_best_objective(0) : T(0);
+            auto kth_best = max_stagnation.has_value() ? this->nth_best_objective(keep - 1) : T(0);
             this->insert_result(std::move(current));
             // we update the search object. A new entry has been found (on the head rank we will
             // automatically update it)
             this->update_objectives({objective_value, this->nth_best_objective(keep)});
+            if (max_stagnation.has_value()
+                && (this->nth_best_objective(0) < best
+                    || this->nth_best_objective(keep - 1) < kth_best))
+              last_improvement.store(evaluated.load() + since_check);
+            if (objective_threshold.has_value() && objective_value <= objective_threshold.value())
+              request_stop(format_string("objective %.5f reached the threshold %.5f",
+                                         objective_value, objective_threshold.value()));
 
             statistics.log_result(iterations_t{rstart + i - start}, objective_value);
           }
-          if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+          if constexpr (SMode == SUBLATTICE_MODE_INTERACT && IMode == ITERATION_MODE_SYSTEMATIC)
             shuffler.template shuffle<IMode>(species);
         }
+        if (has_stop_rules) check_stop_rules(since_check);
         statistics.tock(tick_loop);
 
         statistics.add_working(-iterations);
         statistics.add_finished(iterations);
+        if (completed) {
+          std::scoped_lock lock{finished_chunks_mutex};
+          finished_chunks.push_back(chunk);
+        }
 
         if (callback_ptr) {
           log::trace(
@@ -456,49 +742,146 @@ namespace sqsgen {
 
       log::debug(
           format_string("[Rank %i] spawning thread pool with %i threads (cores available %i)",
-                        this->rank(), this->num_threads(), std::thread::hardware_concurrency()));
+                        this->rank(), pool.get_thread_count(), std::thread::hardware_concurrency()));
+
+#ifdef WITH_MPI
+      // results are reduced along a binomial tree towards the head rank. Each rank merges the best
+      // results of its children into its own collection and forwards a single batch to its parent
+      auto tree = io::mpi::reduction_tree(this->rank(), this->num_ranks());
+      std::vector<int> pending_children{tree.children};
+      // a rank sends the batch of the main objective first, followed by one batch per variant
+      std::map<int, std::size_t> received_batches;
+      const auto receive_from_children = [&] {
+        for (auto child : std::vector{pending_children})
+          io::mpi::recv_all(
+              this->comm, std::vector{this->make_empty_result()},
+              [&](auto&& batch, auto&& source) {
+                log::debug(format_string("[Rank %i] received %i results from rank %i",
+                                         this->rank(), batch.size(), source));
+                auto index = received_batches[source]++;
+                if (index == num_variants) std::erase(pending_children, source);
+                if (index > 0) {
+                  for (auto&& result : batch)
+                    this->insert_variant_result(index - 1, std::move(result), keep,
+                                                max_results_per_objective);
+                  return;
+                }
+                for (auto&& result : batch) {
+                  if (result.objective > this->search_objective()) continue;
+                  if (max_results_per_objective.has_value()
+                      && (this->results_for_objective(result.objective)
+                          > max_results_per_objective.value()))
+                    continue;
+                  auto objective_value = result.objective;
+                  this->insert_result(std::move(result));
+                  this->update_objectives({objective_value, this->nth_best_objective(keep)});
+                }
+              },
+              child);
+      };
+#endif
+
+      std::optional<std::filesystem::path> checkpoint_path;
+      if (this->config.checkpoint.has_value())
+        checkpoint_path = io::checkpoint_path(this->config.checkpoint.value(), this->rank(),
+                                              this->num_ranks());
+      // a resumed run appends to the spill file of the interrupted one
+      if (this->config.spill.has_value())
+        this->_spill = std::make_unique<io::spill_sink<T, SMode>>(
+            io::checkpoint_path(this->config.spill.value(), this->rank(), this->num_ranks()),
+            resumed);
+      const auto variant_checkpoint = [&] {
+        std::vector<std::vector<sqs_result<T, SMode>>> variant_results;
+        for (auto& collection : this->variant_results)
+          variant_results.push_back(collection.best(std::numeric_limits<std::size_t>::max()));
+        return variant_results;
+      };
+      const auto write_checkpoint = [&] {
+        std::vector<std::uint64_t> rng_state;
+        if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+          rng_state.push_back(shuffler.state());
+        else
+          for (auto const& s : shuffler) rng_state.push_back(s.state());
+        std::vector<bounds_t<iterations_t>> chunks;
+        {
+          std::scoped_lock lock{finished_chunks_mutex};
+          chunks = finished_chunks;
+        }
+        io::write_checkpoint(checkpoint_path.value(),
+                             core::sqs_checkpoint<T, SMode>{
+                                 this->config, statistics.data(),
+                                 this->results.best(std::numeric_limits<std::size_t>::max()),
+                                 std::move(chunks), std::move(rng_state), variant_checkpoint()});
+        log::info(format_string("[Rank %i] wrote checkpoint %s", this->rank(),
+                                checkpoint_path.value().string()));
+      };
 
       const auto schedule_main_loop = [&] {
         iterations_t chunk_size = this->config.chunk_size;
         pool.detach_blocks(start, end, worker,
                            static_cast<std::size_t>((end - start) / chunk_size));
+        // while the pool is busy, the main thread merges the results of ranks that already finished
+        // and writes the periodic checkpoints
+        if (mpi_mode || checkpoint_path.has_value()) {
+          auto interval = std::chrono::seconds(this->config.checkpoint_interval);
+          auto last_checkpoint = std::chrono::steady_clock::now();
+          while (!pool.wait_for(std::chrono::milliseconds(50))) {
+#ifdef WITH_MPI
+            if (mpi_mode) receive_from_children();
+#endif
+            if (checkpoint_path.has_value()
+                && std::chrono::steady_clock::now() - last_checkpoint >= interval) {
+              write_checkpoint();
+              last_checkpoint = std::chrono::steady_clock::now();
+            }
+          }
+        }
         pool.wait();
+        if (checkpoint_path.has_value()) write_checkpoint();
       };
       schedule_main_loop();
 
+      // the spilled results replace the ones held in memory, only the keep best objectives remain
+      if (this->_spill) {
+        auto written = this->_spill->close();
+        auto spill_path = this->_spill->path();
+        this->_spill.reset();
+        this->results.clear();
+        auto num_spilled = io::read_spill<T, SMode>(spill_path, [&](auto&& result) {
+          if (max_results_per_objective.has_value()
+              && this->results_for_objective(result.objective) > max_results_per_objective.value())
+            return;
+          this->results.insert(std::forward<decltype(result)>(result));
+          this->results.truncate(keep);
+        });
+        log::info(format_string("[Rank %i] wrote %i results to %s, compacted %i spilled results",
+                                this->rank(), written, spill_path.string(), num_spilled));
+      }
+
       // again we immediately remove the signal handler after they have been used
       if (!mpi_mode) signal::teardown_signal_handlers();
 
-      this->barrier();
 #ifdef WITH_MPI
       if (mpi_mode) {
-        auto num_results{static_cast<int>(this->results.num_results())};
+        core::tick<TIMING_COMM> tick_comm;
+        // the local work is done, hence block until the next child has sent a batch instead of
+        // polling for it
+        while (!pending_children.empty()) {
+          this->comm.probe(pending_children.front(), mpl::tag_t{io::mpi::TAG_BATCH_SIZE});
+          receive_from_children();
+        }
+        if (tree.parent.has_value()) {
+          auto batch = this->results.best(keep + 1);
+          log::debug(format_string("[Rank %i] sending %i results to rank %i", this->rank(),
+                                   batch.size(), tree.parent.value()));
+          io::mpi::send(this->comm, std::move(batch), tree.parent.value());
+          for (auto& collection : this->variant_results)
+            io::mpi::send(this->comm, collection.best(keep + 1), tree.parent.value());
+        }
+        statistics.tock(tick_comm);
+
         auto num_ranks = static_cast<std::size_t>(this->num_ranks());
         if (head) {
-          core::tick<TIMING_COMM> tick_comm;
-          std::vector remaining(num_ranks, -1);
-          this->comm.gather(io::mpi::RANK_HEAD, num_results, remaining.data());
-
-          for (auto i : core::helpers::range(num_ranks))
-            if (i > 0)
-              log::info(format_string("Expecting %i results from rank %i", remaining[i], i));
-          remaining[io::mpi::RANK_HEAD] = 0;
-          auto buffer = this->make_empty_result();
-          while (sum(remaining) > 0)
-            io::mpi::recv_all<sqs_result<T, SMode>>(
-                this->comm, std::forward<decltype(buffer)>(buffer),
-                [&](auto&& result, auto&& rank) {
-                  --remaining[rank];
-                  log::trace(
-                      format_string("[Rank %i, HEAD] received result from rank %i (objective=%.7f, "
-                                    "remaining %i) ",
-                                    io::mpi::RANK_HEAD, rank, result.objective, remaining[rank]));
-                  if (result.objective <= this->search_objective()) {
-                    this->insert_result(std::move(result));
-                    this->update_objectives({result.objective, this->nth_best_objective(keep)});
-                  }
-                });
-
           std::vector<sqs_statistics_data<T>> rank_statistics{statistics.data()};
           rank_statistics.reserve(num_ranks);
           while (rank_statistics.size() < num_ranks)
@@ -515,23 +898,8 @@ namespace sqsgen {
 
           sqsgen::detail::log_statistics(std::forward<sqs_statistics_data<T>>(average),
                                          io::mpi::RANK_HEAD, "(averaged)");
-
-          statistics.tock(tick_comm);
-        } else {
-          core::tick<TIMING_COMM> tick_comm;
-          auto results_sent{0};
-
-          auto sqs_results = this->results.results();
-          this->comm.gather(io::mpi::RANK_HEAD, num_results);
-          for (auto [_, results] : sqs_results)
-            for (auto&& sqs_result : results) {
-              io::mpi::send(this->comm, std::move(sqs_result), io::mpi::RANK_HEAD);
-              log::trace(format_string("[Rank %i] sent result %i / %i to head", this->rank(),
-                                       ++results_sent, num_results));
-            }
-          statistics.tock(tick_comm);
+        } else
           io::mpi::send(this->comm, statistics.data(), io::mpi::RANK_HEAD);
-        }
       }
 #endif
 
@@ -565,18 +933,69 @@ namespace sqsgen {
       std::conditional_t<SMode == SUBLATTICE_MODE_INTERACT, core::optimization_config_data<T>,
                          std::vector<core::optimization_config_data<T>>>
           optimization_configs;
+      // compact results are regenerated from the pair lists and the seeds of this run
+      const auto data = [&](auto index) {
+        auto config_data = this->opt_configs[index].data();
+        if (this->config.compact_results && config_data.pairs.empty())
+          config_data.pairs.assign(this->_pairs[index].begin(), this->_pairs[index].end());
+        return config_data;
+      };
+      if (this->config.compact_results && this->config.iteration_mode == ITERATION_MODE_RANDOM)
+        this->config.seed = as<std::vector>{}(
+            this->opt_configs | views::transform([](auto&& c) -> std::optional<std::uint64_t> {
+              return c.shuffler.state();
+            }));
       if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
-        optimization_configs = this->opt_configs.front().data();
+        optimization_configs = data(0);
       else if constexpr (SMode == SUBLATTICE_MODE_SPLIT)
-        optimization_configs = as<std::vector>{}(
-            this->opt_configs | views::transform([](auto&& c) { return c.data(); }));
+        optimization_configs = as<std::vector>{}(range(this->opt_configs.size())
+                                                 | views::transform(data));
+
+      // each variant is reported as a pack of its own, under the configuration it was scored with
+      std::vector<core::sqs_result_pack<T, SMode>> variant_packs;
+      for (auto v = 0; v < num_variants; ++v) {
+        auto variant_results = this->variant_results[v].remove_duplicates();
+        if (this->is_head())
+          for (auto& [_, results] : variant_results)
+            for (auto& result : results)
+              sqsgen::detail::postprocess_results(result, this->opt_configs);
+        auto const& variant = this->config.variants[v];
+        const auto variant_data = [&](auto index) {
+          auto config_data = data(index);
+          config_data.prefactors = variant.prefactors[index];
+          config_data.pair_weights = variant.pair_weights[index];
+          config_data.target_objective = variant.target_objective[index];
+          config_data.shell_weights = variant.shell_weights[index];
+          return config_data;
+        };
+        decltype(optimization_configs) variant_configs;
+        if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+          variant_configs = variant_data(0);
+        else if constexpr (SMode == SUBLATTICE_MODE_SPLIT)
+          variant_configs = as<std::vector>{}(range(this->opt_configs.size())
+                                              | views::transform(variant_data));
+        auto variant_statistics = statistics.data();
+        if (!variant_results.empty()) {
+          auto best = std::get<1>(variant_results.front()).front();
+          variant_statistics.best_objective = best.objective;
+          if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+            variant_statistics.best_rank = best.iteration;
+          else
+            variant_statistics.best_rank = best.sublattices.front().iteration;
+        }
+        variant_packs.emplace_back(this->config.with_objective(variant),
+                                   std::move(variant_configs), std::move(variant_results),
+                                   std::move(variant_statistics));
+      }
 
-      return core::sqs_result_pack<T, SMode>{
+      core::sqs_result_pack<T, SMode> pack{
           std::move(this->config),
           std::move(optimization_configs),
           std::move(filtered_results),
           statistics.data(),
       };
+      pack.variants = std::move(variant_packs);
+      return pack;
     }
   };
 
@@ -596,32 +1015,166 @@ namespace sqsgen {
     using optimizer_output_t
         = cat_variants<output_for_prec_t<float>, output_for_prec_t<double>>::type;
 
-    template <class T>
-    optimizer_output_t run_optimization(core::configuration<T>&& conf,
-                                        log::level log_level = log::level::warn,
-                                        std::optional<sqs_callback_t> callback = std::nullopt) {
+    // constructs the optimizer for the iteration and sublattice mode of conf and passes it to fn
+    template <class T, class Fn>
+    optimizer_output_t with_optimizer(core::configuration<T>&& conf,
+                                      core::geometry_cache<T>* geometry, Fn&& fn) {
+      const auto make = [&]<IterationMode IMode, SublatticeMode SMode>() {
+        optimizer<T, IMode, SMode> opt(std::forward<core::configuration<T>>(conf), geometry);
+        return optimizer_output_t{fn(opt)};
+      };
       if (conf.iteration_mode == ITERATION_MODE_RANDOM
           && conf.sublattice_mode == SUBLATTICE_MODE_INTERACT)
-        return optimizer<T, ITERATION_MODE_RANDOM, SUBLATTICE_MODE_INTERACT>(
-                   std::forward<core::configuration<T>>(conf))
-            .run(log_level, callback);
-
+        return make.template operator()<ITERATION_MODE_RANDOM, SUBLATTICE_MODE_INTERACT>();
       else if (conf.iteration_mode == ITERATION_MODE_RANDOM
                && conf.sublattice_mode == SUBLATTICE_MODE_SPLIT)
-        return optimizer<T, ITERATION_MODE_RANDOM, SUBLATTICE_MODE_SPLIT>(
-                   std::forward<core::configuration<T>>(conf))
-            .run(log_level, callback);
+        return make.template operator()<ITERATION_MODE_RANDOM, SUBLATTICE_MODE_SPLIT>();
       else if (conf.iteration_mode == ITERATION_MODE_SYSTEMATIC
                && conf.sublattice_mode == SUBLATTICE_MODE_INTERACT)
-        return optimizer<T, ITERATION_MODE_SYSTEMATIC, SUBLATTICE_MODE_INTERACT>(
-                   std::forward<core::configuration<T>>(conf))
-            .run(log_level, callback);
+        return make.template operator()<ITERATION_MODE_SYSTEMATIC, SUBLATTICE_MODE_INTERACT>();
       else
         throw std::runtime_error("Invalid configuration of iteration and sublattice mode");
     }
 
+    template <class T>
+    optimizer_output_t run_optimization(core::configuration<T>&& conf,
+                                        log::level log_level = log::level::warn,
+                                        std::optional<sqs_callback_t> callback = std::nullopt) {
+      auto geometry = conf.geometry;
+      return with_optimizer<T>(std::forward<core::configuration<T>>(conf), nullptr, [&](auto& opt) {
+        if (geometry) geometry->clear();
+        return opt.run(log_level, callback);
+      });
+    }
+
+    using sweep_callback_t = std::function<void(std::size_t, optimizer_output_t const&)>;
+
+    template <class T>
+    std::vector<optimizer_output_t> run_sweep(std::vector<core::configuration<T>>&& configs,
+                                              log::level log_level = log::level::warn,
+                                              std::optional<sqs_callback_t> callback = std::nullopt,
+                                              std::optional<sweep_callback_t> finished
+                                              = std::nullopt) {
+      // the compositions of a parsed sweep already share their context
+      auto geometry = configs.empty() || !configs.front().geometry
+                          ? std::make_shared<core::geometry_cache<T>>(
+                              configs.empty() ? std::nullopt : configs.front().geometry_cache)
+                          : configs.front().geometry;
+      std::shared_ptr<thread_pool_t> pool;
+      std::vector<optimizer_output_t> outputs;
+      outputs.reserve(configs.size());
+      for (auto&& config : configs) {
+        outputs.push_back(with_optimizer<T>(std::move(config), geometry.get(), [&](auto& opt) {
+          if (pool) opt.share_pool(pool);
+          log::info(format_string("Running composition %i of %i of the sweep", outputs.size() + 1,
+                                  configs.size()));
+          auto output = opt.run(log_level, callback);
+          pool = opt.shared_pool();
+          return output;
+        }));
+        if (finished.has_value()) finished.value()(outputs.size() - 1, outputs.back());
+      }
+      geometry->clear();
+      return outputs;
+    }
+
+    template <class T, SublatticeMode SMode>
+    optimizer_output_t resume_optimization(core::sqs_checkpoint<T, SMode>&& checkpoint,
+                                           log::level log_level = log::level::warn,
+                                           std::optional<sqs_callback_t> callback = std::nullopt) {
+      const auto resume = [&]<IterationMode IMode>() {
+        optimizer<T, IMode, SMode> opt(core::configuration<T>{checkpoint.config});
+        opt.restore(std::forward<core::sqs_checkpoint<T, SMode>>(checkpoint));
+        return opt.run(log_level, callback);
+      };
+      if (checkpoint.config.iteration_mode == ITERATION_MODE_RANDOM)
+        return resume.template operator()<ITERATION_MODE_RANDOM>();
+      if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+        if (checkpoint.config.iteration_mode == ITERATION_MODE_SYSTEMATIC)
+          return resume.template operator()<ITERATION_MODE_SYSTEMATIC>();
+      throw std::runtime_error("Invalid configuration of iteration and sublattice mode");
+    }
+
   }  // namespace detail
 
+  /*
+   * Re-ranks the results of a pack under the objective function of config, which must describe the
+   * same run as the configuration of the pack (see io::config::parse_rescore_config). The bonds of
+   * each result are recounted from its configuration, the results are evaluated in parallel
+   */
+  template <class T, SublatticeMode SMode>
+  core::sqs_result_pack<T, SMode> rescore(core::sqs_result_pack<T, SMode> const& pack,
+                                          core::configuration<T>&& config) {
+    if (config.sublattice_mode != pack.config.sublattice_mode
+        || config.iteration_mode != pack.config.iteration_mode)
+      throw std::invalid_argument(
+          "the results can only be rescored under the iteration and sublattice mode of their run");
+    auto opt_configs
+        = core::detail::opt_config_from_config<T, SMode>(core::configuration<T>{config});
+    const auto sublattice_config = [&](auto sigma) -> core::optimization_config_data<T> const& {
+      if constexpr (SMode == SUBLATTICE_MODE_SPLIT)
+        return opt_configs.at(sigma);
+      else
+        return opt_configs;
+    };
+    std::vector<core::detail::sqs_result_wrapper<T, SMode>> previous;
+    for (auto&& [_, collection] : pack)
+      previous.insert(previous.end(), collection.begin(), collection.end());
+
+    std::vector<sqs_result<T, SMode>> rescored(previous.size());
+    const auto worker = [&](std::size_t index) {
+      // a copy, such that compact results of the pack are not materialized
+      auto result = previous[index];
+      const auto evaluate = [&](auto sigma, configuration_t const& species) {
+        auto const& opt_config = sublattice_config(sigma);
+        return std::get<0>(core::detail::evaluate<T>(
+            opt_config, core::detail::sorted_order<T>(species, opt_config)));
+      };
+      if constexpr (SMode == SUBLATTICE_MODE_INTERACT) {
+        auto species = result.configuration();
+        auto objective = evaluate(0, species);
+        rescored[index] = config.compact_results
+                              ? sqs_result<T, SMode>(objective, result.iteration)
+                              : sqs_result<T, SMode>(objective, species, result.iteration);
+      } else {
+        std::vector<T> objectives;
+        std::vector<configuration_t> species;
+        for (auto sigma = 0; sigma < result.sublattices.size(); ++sigma) {
+          species.push_back(result.sublattices[sigma].configuration());
+          objectives.push_back(evaluate(sigma, species.back()));
+        }
+        auto objective = core::helpers::sum(objectives);
+        auto iteration = result.sublattices.front().iteration;
+        rescored[index]
+            = config.compact_results
+                  ? sqs_result<T, SMode>(objective, objectives, iteration)
+                  : sqs_result<T, SMode>(objective, objectives, species, iteration);
+      }
+    };
+    const auto& thread_config = config.thread_config;
+    BS::thread_pool<> pool(thread_config.size() == 1 ? thread_config.front()
+                                                     : std::thread::hardware_concurrency());
+    pool.detach_loop(std::size_t{0}, previous.size(), worker);
+    pool.wait();
+
+    std::map<T, std::vector<sqs_result<T, SMode>>> by_objective;
+    for (auto&& result : rescored) by_objective[result.objective].push_back(std::move(result));
+    auto statistics = pack.statistics;
+    if (!by_objective.empty()) {
+      auto const& best = by_objective.begin()->second.front();
+      statistics.best_objective = best.objective;
+      if constexpr (SMode == SUBLATTICE_MODE_INTERACT)
+        statistics.best_rank = best.iteration;
+      else
+        statistics.best_rank = best.sublattices.front().iteration;
+    }
+    core::sqs_result_pack_data_t<T, SMode> results;
+    results.reserve(by_objective.size());
+    for (auto&& entry : by_objective) results.insert(std::move(entry));
+    return core::sqs_result_pack<T, SMode>(std::move(config), std::move(opt_configs),
+                                           std::move(results), std::move(statistics));
+  }
+
   inline detail::optimizer_output_t run_optimization(
       std::variant<core::configuration<float>, core::configuration<double>>&& conf,
       log::level level = log::level::warn, std::optional<sqs_callback_t> callback = std::nullopt) {
@@ -632,6 +1185,36 @@ namespace sqsgen {
         },
         std::forward<decltype(conf)>(conf));
   }
+
+  /*
+   * Runs the configurations of a sweep (see io::config::parse_sweep) one after another on a single
+   * thread pool. The pair lists of structures with the same geometry are computed only once, a
+   * result pack is returned for each configuration. If set, finished is invoked with the index and
+   * the pack of each configuration as soon as it is done
+   */
+  inline std::vector<detail::optimizer_output_t> run_sweep(
+      std::variant<std::vector<core::configuration<float>>,
+                   std::vector<core::configuration<double>>>&& configs,
+      log::level level = log::level::warn, std::optional<sqs_callback_t> callback = std::nullopt,
+      std::optional<detail::sweep_callback_t> finished = std::nullopt) {
+    return std::visit(
+        [&]<class T>(std::vector<core::configuration<T>>&& c) {
+          return detail::run_sweep<T>(std::forward<std::vector<core::configuration<T>>>(c), level,
+                                      callback, finished);
+        },
+        std::forward<decltype(configs)>(configs));
+  }
+
+  inline detail::optimizer_output_t resume_optimization(
+      core::sqs_checkpoint_t&& checkpoint, log::level level = log::level::warn,
+      std::optional<sqs_callback_t> callback = std::nullopt) {
+    return std::visit(
+        [&]<class T, SublatticeMode SMode>(core::sqs_checkpoint<T, SMode>&& c) {
+          return detail::resume_optimization<T, SMode>(
+              std::forward<core::sqs_checkpoint<T, SMode>>(c), level, callback);
+        },
+        std::forward<decltype(checkpoint)>(checkpoint));
+  }
 }  // namespace sqsgen
 
 #endif  // SQSGEN_SQS_H
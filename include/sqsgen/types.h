@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "absl/hash/hash.h"
+#include "sqsgen/core/helpers/packed_vector.h"
 #include "sqsgen/core/helpers/sorted_vector.h"
 
 namespace sqsgen {
@@ -19,6 +20,7 @@ namespace sqsgen {
   using specie_t = std::uint_fast8_t;
   using rank_t = boost::multiprecision::cpp_int;
   using configuration_t = std::vector<specie_t>;
+  using packed_configuration_t = core::helpers::packed_vector<specie_t>;
 
   template <class T> using vset = core::helpers::sorted_vector<T>;
 
@@ -77,6 +79,13 @@ namespace sqsgen {
     SUBLATTICE_MODE_SPLIT,
   };
 
+  enum DeduplicationMode {
+    DEDUPLICATION_MODE_INVALID = -1,
+    DEDUPLICATION_MODE_EXACT,
+    DEDUPLICATION_MODE_TRANSLATIONS,
+    DEDUPLICATION_MODE_SYMMETRY,
+  };
+
   using composition_t = std::map<specie_t, usize_t>;
 
   using iterations_t = unsigned long long;
@@ -94,12 +103,20 @@ namespace sqsgen {
 
   template <class, SublatticeMode> struct sqs_result {};
 
+  /*
+   * A result found at (global) iteration index "iteration". The species are stored bit-packed, the
+   * SRO parameters are usually left empty and recomputed from the species when needed. A compact
+   * result only keeps the objective and the iteration, its species are regenerated from the seed
+   * (random mode) or the rank iteration + 1 (systematic mode)
+   */
   template <class T> struct sqs_result<T, SUBLATTICE_MODE_INTERACT> {
     T objective;
-    configuration_t species;
+    packed_configuration_t species;
     cube_t<T> sro;
+    iterations_t iteration{};
 
     template <typename H> friend H AbslHashValue(H h, const sqs_result& c) {
+      if (c.compact()) return H::combine(std::move(h), c.iteration);
       return H::combine(std::move(h), c.species);
     }
 
@@ -109,13 +126,15 @@ namespace sqsgen {
     sqs_result(const sqs_result& other)
         : objective(other.objective),
           species(other.species),
-          sro(other.sro) {}  // Eigen::Tensor should handle this properly
+          sro(other.sro),
+          iteration(other.iteration) {}  // Eigen::Tensor should handle this properly
 
     // Explicit move constructor
     sqs_result(sqs_result&& other) noexcept
         : objective(std::move(other.objective)),
           species(std::move(other.species)),
-          sro(std::move(other.sro)) {}  // Eigen::Tensor should handle this properly
+          sro(std::move(other.sro)),
+          iteration(other.iteration) {}  // Eigen::Tensor should handle this properly
 
     // Assignment operators
     sqs_result& operator=(const sqs_result& other) {
@@ -123,6 +142,7 @@ namespace sqsgen {
         objective = other.objective;
         species = other.species;
         sro = other.sro;
+        iteration = other.iteration;
       }
       return *this;
     }
@@ -132,19 +152,32 @@ namespace sqsgen {
         objective = std::move(other.objective);
         species = std::move(other.species);
         sro = std::move(other.sro);
+        iteration = other.iteration;
       }
       return *this;
     }
 
-    sqs_result(T objective, configuration_t species, cube_t<T> sro)
-        : objective(objective), species(std::move(species)), sro(std::move(sro)) {}
+    sqs_result(T objective, configuration_t const& species, cube_t<T> sro,
+               iterations_t iteration = 0)
+        : objective(objective), species(species), sro(std::move(sro)), iteration(iteration) {}
+
+    sqs_result(T objective, configuration_t const& species, iterations_t iteration)
+        : objective(objective), species(species), iteration(iteration) {}
+
+    // compact result
+    sqs_result(T objective, iterations_t iteration) : objective(objective), iteration(iteration) {}
+
+    // compatibility constructors to SPLIT mode result
+    sqs_result(T, T objective, configuration_t const& species, iterations_t iteration)
+        : sqs_result(objective, species, iteration) {}
 
-    // compatibility constructor to SPLIT mode result
-    sqs_result(T, T objective, configuration_t species, cube_t<T> sro)
-        : sqs_result(objective, std::move(species), std::move(sro)) {}
+    sqs_result(T, T objective, iterations_t iteration) : sqs_result(objective, iteration) {}
+
+    [[nodiscard]] bool compact() const { return species.empty(); }
 
     bool operator==(sqs_result const& other) const {
-      return objective == other.objective && species == other.species;
+      return objective == other.objective && species == other.species
+             && (!compact() || iteration == other.iteration);
     }
   };
 
@@ -165,13 +198,21 @@ namespace sqsgen {
         : objective(objective), sublattices(sublattices) {}
 
     sqs_result(T objective, std::vector<T> const& objectives,
-               const std::vector<configuration_t>& species, std::vector<cube_t<T>> const& sro)
+               const std::vector<configuration_t>& species, iterations_t iteration)
         : objective(objective) {
-      if (objectives.size() != species.size() || objectives.size() != sro.size())
+      if (objectives.size() != species.size())
         throw std::invalid_argument("invalid number entries");
       sublattices.reserve(objectives.size());
       for (auto i = 0; i < objectives.size(); ++i)
-        sublattices.push_back({objectives[i], species[i], sro[i]});
+        sublattices.push_back({objectives[i], species[i], iteration});
+    }
+
+    // compact result, all sublattices were shuffled in the same iteration
+    sqs_result(T objective, std::vector<T> const& objectives, iterations_t iteration)
+        : objective(objective) {
+      sublattices.reserve(objectives.size());
+      for (auto sublattice_objective : objectives)
+        sublattices.push_back({sublattice_objective, iteration});
     }
 
     bool operator==(sqs_result const& other) const {
@@ -217,6 +258,7 @@ namespace sqsgen {
     STRUCTURE_FORMAT_CIF = 3,
     STRUCTURE_FORMAT_POSCAR = 4,
     STRUCTURE_FORMAT_PDB = 5,
+    STRUCTURE_FORMAT_XYZ = 6,
   };
 
   template <class T> class sqs_callback_context {
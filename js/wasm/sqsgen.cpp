@@ -193,6 +193,7 @@ EMSCRIPTEN_BINDINGS(m) {
       .function("sqsgen", &sqs_results::format<sqsgen::STRUCTURE_FORMAT_JSON_SQSGEN>)
       .function("ase", &sqs_results::format<sqsgen::STRUCTURE_FORMAT_JSON_ASE>)
       .function("pymatgen", &sqs_results::format<sqsgen::STRUCTURE_FORMAT_JSON_PYMATGEN>)
+      .function("xyz", &sqs_results::format<sqsgen::STRUCTURE_FORMAT_XYZ>)
       .function("msgpack", &sqs_results::msgpack)
       .function("numObjectives", &sqs_results::num_objectives)
       .function("numSolutions", &sqs_results::num_solutions)
@@ -8,10 +8,14 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <sstream>
+
 #include "sqsgen/core/results.h"
 #include "sqsgen/io/config/combined.h"
 #include "sqsgen/io/dict.h"
 #include "sqsgen/io/json.h"
+#include "sqsgen/io/merge.h"
+#include "sqsgen/io/pack.h"
 #include "sqsgen/io/parsing.h"
 #include "sqsgen/io/structure.h"
 #include "sqsgen/sqs.h"
@@ -31,12 +35,12 @@ nlohmann::json read_msgpack(std::string const &filename) {
   return nlohmann::json::from_msgpack(ifs);
 }
 
-using result_packt_t = std::variant<core::sqs_result_pack<float, SUBLATTICE_MODE_SPLIT>,
-                                    core::sqs_result_pack<double, SUBLATTICE_MODE_SPLIT>,
-                                    core::sqs_result_pack<float, SUBLATTICE_MODE_INTERACT>,
-                                    core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>>;
+using result_packt_t = io::sqs_result_pack_t;
 result_packt_t load_result_pack(bool is_file, std::string const &data, Prec prec = PREC_SINGLE) {
   using namespace sqsgen;
+  if (is_file && io::is_columnar_pack(std::filesystem::path(data)))
+    return io::read_pack(std::filesystem::path(data));
+  if (std::istringstream in(data); !is_file && io::is_columnar_pack(in)) return io::read_pack(in);
   nlohmann::json pack_json;
   if (!is_file)
     pack_json = nlohmann::json::from_msgpack(data);
@@ -175,6 +179,8 @@ template <string_literal Name, class T> void bind_structure(py::module &m) {
                  return io::structure_adapter<T, STRUCTURE_FORMAT_POSCAR>::format(s);
                case STRUCTURE_FORMAT_PDB:
                  return io::structure_adapter<T, STRUCTURE_FORMAT_PDB>::format(s);
+               case STRUCTURE_FORMAT_XYZ:
+                 return io::structure_adapter<T, STRUCTURE_FORMAT_XYZ>::format(s);
                default:
                  throw py::value_error("Unknown Structure format");
              };
@@ -201,6 +207,15 @@ template <string_literal Name, class T> void bind_structure(py::module &m) {
       });
 }
 
+template <string_literal Name, class T> void bind_objective_variant(py::module &m) {
+  using namespace sqsgen::core;
+  py::class_<objective_variant<T>>(m, format_prec<Name, T>().c_str())
+      .def_readwrite("shell_weights", &objective_variant<T>::shell_weights)
+      .def_readwrite("prefactors", &objective_variant<T>::prefactors)
+      .def_readwrite("pair_weights", &objective_variant<T>::pair_weights)
+      .def_readwrite("target_objective", &objective_variant<T>::target_objective);
+}
+
 template <string_literal Name, class T> void bind_configuration(py::module &m) {
   using namespace sqsgen::core;
   py::class_<configuration<T>>(m, format_prec<Name, T>().c_str())
@@ -218,7 +233,19 @@ template <string_literal Name, class T> void bind_configuration(py::module &m) {
       .def_readwrite("iterations", &configuration<T>::iterations)
       .def_readwrite("chunk_size", &configuration<T>::chunk_size)
       .def_readwrite("thread_config", &configuration<T>::thread_config)
+      .def_readwrite("shared_memory", &configuration<T>::shared_memory)
+      .def_readwrite("checkpoint", &configuration<T>::checkpoint)
+      .def_readwrite("checkpoint_interval", &configuration<T>::checkpoint_interval)
+      .def_readwrite("geometry_cache", &configuration<T>::geometry_cache)
+      .def_readwrite("spill", &configuration<T>::spill)
+      .def_readwrite("spill_limit", &configuration<T>::spill_limit)
+      .def_readwrite("max_time", &configuration<T>::max_time)
+      .def_readwrite("objective_threshold", &configuration<T>::objective_threshold)
+      .def_readwrite("max_stagnation", &configuration<T>::max_stagnation)
+      .def_readwrite("compact_results", &configuration<T>::compact_results)
+      .def_readwrite("deduplication", &configuration<T>::deduplication)
       .def_readwrite("composition", &configuration<T>::composition)
+      .def_readwrite("variants", &configuration<T>::variants)
       .def("bytes", &to_bytes<configuration<T>>)
       .def("json",
            [](configuration<T> const &config) {
@@ -259,6 +286,7 @@ void bind_result(py::module &m) {
     py::class_<sqs_result_wrapper<T, Mode>>(
         m, format_prec<format_sublattice<Name, Mode>(), T>().c_str())
         .def_readonly("objective", &sqs_result_wrapper<T, Mode>::objective)
+        .def_readonly("iteration", &sqs_result_wrapper<T, Mode>::iteration)
         .def_property_readonly("species", &sqs_result_wrapper<T, Mode>::configuration)
         .def("structure", &sqs_result_wrapper<T, Mode>::structure, py::return_value_policy::move)
         .def(
@@ -302,6 +330,15 @@ void bind_result(py::module &m) {
   }
 }
 
+template <class T, sqsgen::SublatticeMode Mode, class Document>
+std::variant<sqsgen::core::sqs_result_pack<T, Mode>, sqsgen::io::parse_error>
+rescore_result_pack(sqsgen::core::sqs_result_pack<T, Mode> const &pack, Document const &params) {
+  auto config = sqsgen::io::config::parse_rescore_config<T>(params, pack.config);
+  if (config.failed()) return config.error();
+  py::gil_scoped_release nogil{};
+  return sqsgen::rescore(pack, config.result());
+}
+
 template <string_literal Name, class T, sqsgen::SublatticeMode Mode>
 void bind_result_pack(py::module &m) {
   using namespace sqsgen;
@@ -310,6 +347,7 @@ void bind_result_pack(py::module &m) {
   py::class_<sqs_result_pack<T, Mode>>(m, format_prec<format_sublattice<Name, Mode>(), T>().c_str())
       .def_readonly("statistics", &sqs_result_pack<T, Mode>::statistics)
       .def_readonly("config", &sqs_result_pack<T, Mode>::config)
+      .def_readonly("variants", &sqs_result_pack<T, Mode>::variants)
       .def("__iter__",
            [](sqs_result_pack<T, Mode> &self) {
              return py::make_iterator(self.begin(), self.end());
@@ -324,6 +362,18 @@ void bind_result_pack(py::module &m) {
            })
       .def("num_objectives", &sqs_result_pack<T, Mode>::size)
       .def("num_results", &sqs_result_pack<T, Mode>::num_results)
+      .def(
+          "rescore",
+          [](sqs_result_pack<T, Mode> const &self, py::dict const &params) {
+            return rescore_result_pack(self, py::handle(params));
+          },
+          py::arg("params"))
+      .def(
+          "rescore",
+          [](sqs_result_pack<T, Mode> const &self, std::string const &json) {
+            return rescore_result_pack(self, nlohmann::json::parse(json));
+          },
+          py::arg("params_json"))
       .def("bytes", &to_bytes<sqs_result_pack<T, Mode>>)
       .def_static("from_bytes", &from_bytes<sqs_result_pack<T, Mode>>, py::arg("bytes"))
       .def("best", [](sqs_result_pack<T, Mode> &self) {
@@ -334,6 +384,31 @@ void bind_result_pack(py::module &m) {
       });
 }
 
+template <string_literal Name, class T, sqsgen::SublatticeMode Mode>
+void bind_result_pack_view(py::module &m) {
+  using namespace sqsgen;
+  using view_t = io::pack_view<T, Mode>;
+  py::class_<view_t>(m, format_prec<format_sublattice<Name, Mode>(), T>().c_str())
+      .def_property_readonly("config", [](view_t &self) { return self.config(); })
+      .def_property_readonly("statistics", &view_t::statistics)
+      .def("__len__", &view_t::size)
+      .def("__getitem__",
+           [](view_t &self, int index) {
+             if (index < 0) index += self.size();
+             if (index < 0 || index >= self.size()) throw std::out_of_range("Index out of range");
+             return std::make_tuple(self.objective(index), self.results(index));
+           })
+      .def("num_objectives", &view_t::size)
+      .def("num_results", py::overload_cast<>(&view_t::num_results, py::const_))
+      .def("num_results", py::overload_cast<std::size_t>(&view_t::num_results, py::const_),
+           py::arg("objective"))
+      .def("objective", &view_t::objective, py::arg("objective"))
+      .def("result", &view_t::result, py::arg("objective"), py::arg("index"))
+      .def("num_variants", &view_t::num_variants)
+      .def("variant", &view_t::variant, py::arg("index"))
+      .def("load", &view_t::load);
+}
+
 PYBIND11_MODULE(_core, m) {
   using namespace sqsgen;
   m.doc()
@@ -383,12 +458,19 @@ PYBIND11_MODULE(_core, m) {
       .value("split", SUBLATTICE_MODE_SPLIT)
       .export_values();
 
+  py::enum_<DeduplicationMode>(m, "DeduplicationMode")
+      .value("exact", DEDUPLICATION_MODE_EXACT)
+      .value("translations", DEDUPLICATION_MODE_TRANSLATIONS)
+      .value("symmetry", DEDUPLICATION_MODE_SYMMETRY)
+      .export_values();
+
   py::enum_<StructureFormat>(m, "StructureFormat")
       .value("json_sqsgen", STRUCTURE_FORMAT_JSON_SQSGEN)
       .value("json_ase", STRUCTURE_FORMAT_JSON_ASE)
       .value("json_pymatgen", STRUCTURE_FORMAT_JSON_PYMATGEN)
       .value("cif", STRUCTURE_FORMAT_CIF)
       .value("poscar", STRUCTURE_FORMAT_POSCAR)
+      .value("xyz", STRUCTURE_FORMAT_XYZ)
       .export_values();
 
   py::enum_<log::level>(m, "LogLevel")
@@ -516,6 +598,48 @@ PYBIND11_MODULE(_core, m) {
       py::arg("config"), py::arg("log_level") = log::level::warn,
       py::arg("callback") = std::nullopt);
 
+  m.def(
+      "parse_sweep",
+      [](py::dict const &config) { return unwrap(io::config::parse_sweep(py::handle(config))); },
+      py::arg("config"));
+
+  m.def(
+      "parse_sweep",
+      [](std::string const &json) {
+        py::gil_scoped_release nogil{};
+        nlohmann::json document = nlohmann::json::parse(json);
+        return unwrap(io::config::parse_sweep(document));
+      },
+      py::arg("config_json"));
+
+  m.def(
+      "sweep",
+      [](std::variant<std::vector<core::configuration<float>>,
+                      std::vector<core::configuration<double>>> &&configs,
+         log::level log_level, std::optional<sqs_callback_t> callback) {
+        if (callback.has_value()) {
+          py::gil_scoped_release nogil{};
+          return sqsgen::run_sweep(std::forward<decltype(configs)>(configs), log_level, callback);
+        } else {
+          return sqsgen::run_sweep(std::forward<decltype(configs)>(configs), log_level,
+                                   std::nullopt);
+        }
+      },
+      py::arg("configs"), py::arg("log_level") = log::level::warn,
+      py::arg("callback") = std::nullopt);
+
+  m.def(
+      "resume",
+      [](std::string const &checkpoint, log::level log_level,
+         std::optional<sqs_callback_t> callback) {
+        py::gil_scoped_release nogil{};
+        return sqsgen::resume_optimization(io::read_checkpoint(checkpoint), log_level, callback);
+      },
+      py::arg("checkpoint"), py::arg("log_level") = log::level::warn,
+      py::arg("callback") = std::nullopt);
+
+  bind_objective_variant<"ObjectiveVariant", float>(m);
+  bind_objective_variant<"ObjectiveVariant", double>(m);
   bind_configuration<"SqsConfiguration", float>(m);
   bind_configuration<"SqsConfiguration", double>(m);
 
@@ -530,4 +654,34 @@ PYBIND11_MODULE(_core, m) {
         return load_result_pack(std::filesystem::exists(data), data, prec);
       },
       py::arg("data"), py::arg("prec") = PREC_SINGLE);
+
+  bind_result_pack_view<"SqsResultPackView", float, SUBLATTICE_MODE_INTERACT>(m);
+  bind_result_pack_view<"SqsResultPackView", float, SUBLATTICE_MODE_SPLIT>(m);
+  bind_result_pack_view<"SqsResultPackView", double, SUBLATTICE_MODE_INTERACT>(m);
+  bind_result_pack_view<"SqsResultPackView", double, SUBLATTICE_MODE_SPLIT>(m);
+
+  m.def(
+      "open_result_pack",
+      [](std::string const &path, Prec prec) -> io::pack_view_t {
+        if (io::is_columnar_pack(std::filesystem::path(path)))
+          return io::open_pack(std::filesystem::path(path));
+        return io::make_view(load_result_pack(true, path, prec));
+      },
+      py::arg("path"), py::arg("prec") = PREC_SINGLE);
+
+  m.def(
+      "merge_result_packs",
+      [](std::vector<std::string> const &paths, std::optional<std::size_t> keep,
+         Prec prec) -> io::sqs_result_pack_t {
+        py::gil_scoped_release nogil{};
+        return io::merge_packs(
+            paths.size(),
+            [&](std::size_t i) -> io::pack_view_t {
+              if (io::is_columnar_pack(std::filesystem::path(paths[i])))
+                return io::open_pack(std::filesystem::path(paths[i]));
+              return io::make_view(load_result_pack(true, paths[i], prec));
+            },
+            keep);
+      },
+      py::arg("paths"), py::arg("keep") = std::nullopt, py::arg("prec") = PREC_SINGLE);
 }
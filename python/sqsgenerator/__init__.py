@@ -1,35 +1,47 @@
 import warnings
 
 from ._adapters import HAVE_ASE, HAVE_PYMATGEN, available_formats, read, write
-from ._optimize import optimize, parse_config
+from ._optimize import optimize, parse_config, parse_sweep, rescore, resume, sweep
 from .core import (
     Atom,
+    DeduplicationMode,
     IterationMode,
     Prec,
     SqsResult,
     SqsResultPack,
+    SqsResultPackView,
     StructureFormat,
     SublatticeMode,
     __version__,
     load_result_pack,
+    merge_result_packs,
+    open_result_pack,
 )
 
 __all__ = [
     "HAVE_ASE",
     "HAVE_PYMATGEN",
     "Atom",
+    "DeduplicationMode",
     "IterationMode",
     "Prec",
     "SqsResult",
     "SqsResultPack",
+    "SqsResultPackView",
     "StructureFormat",
     "SublatticeMode",
     "__version__",
     "available_formats",
     "load_result_pack",
+    "merge_result_packs",
+    "open_result_pack",
     "optimize",
     "parse_config",
+    "parse_sweep",
     "read",
+    "rescore",
+    "resume",
+    "sweep",
     "write",
 ]
 
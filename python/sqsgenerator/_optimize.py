@@ -4,8 +4,10 @@ from typing import Any, Callable, Optional, Union
 
 from ._adapters import read as _read
 from .core import (
+    DeduplicationMode,
     IterationMode,
     LogLevel,
+    ParseError,
     Prec,
     SqsCallback,
     SqsConfiguration,
@@ -21,8 +23,17 @@ from .core import (
 from .core import (
     parse_config as _parse_config,
 )
+from .core import (
+    parse_sweep as _parse_sweep,
+)
+from .core import (
+    resume as _resume,
+)
+from .core import (
+    sweep as _sweep,
+)
 
-__all__ = ["optimize", "parse_config"]
+__all__ = ["optimize", "parse_config", "parse_sweep", "rescore", "resume", "sweep"]
 
 
 def _parse_prec(string: str) -> Prec:
@@ -83,6 +94,29 @@ def _parse_sublattice_mode(string: str) -> SublatticeMode:
         )
 
 
+def _parse_deduplication_mode(string: str) -> DeduplicationMode:
+    """
+    Parse a string into a DeduplicationMode enum value.
+
+    Args:
+        string (str): The string to parse.
+
+    Returns:
+        DeduplicationMode: The corresponding DeduplicationMode enum value.
+    """
+    if (mode := string.lower()) == "exact":
+        return DeduplicationMode.exact
+    elif mode == "translations":
+        return DeduplicationMode.translations
+    elif mode == "symmetry":
+        return DeduplicationMode.symmetry
+    else:
+        raise ValueError(
+            f"Invalid deduplication mode: {string}. "
+            "Use 'exact', 'translations' or 'symmetry'."
+        )
+
+
 def _preprocess_structure(structure_config: dict[str, Any]) -> dict[str, Any]:
     """
     Preprocess the structure configuration dictionary inplace.
@@ -113,18 +147,18 @@ def _preprocess_structure(structure_config: dict[str, Any]) -> dict[str, Any]:
     return structure_config
 
 
-def parse_config(
+def _preprocess_config(
     config: Union[dict[str, Any], str], inplace: bool = False
-) -> SqsConfiguration:
+) -> dict[str, Any]:
     """
-    Parse the configuration dictionary into a SqsConfiguration object.
+    Convert the string values of a configuration dictionary into the types expected by the core.
 
     Args:
-        config (dict[str, Any]): Configuration dictionary.
-        inplace (bool, optional): If `True`, return a modified version of the input dictionary.
+        config (dict[str, Any] | str): Configuration dictionary or JSON string.
+        inplace (bool, optional): If `True`, modify the input dictionary.
 
     Returns:
-        SqsConfiguration: Parsed configuration object.
+        dict[str, Any]: The preprocessed configuration dictionary.
     """
     if isinstance(config, str):
         config = json.loads(config)
@@ -140,8 +174,41 @@ def parse_config(
     apply("prec", _parse_prec)
     apply("iteration_mode", _parse_iteration_mode)
     apply("sublattice_mode", _parse_sublattice_mode)
+    apply("deduplication", _parse_deduplication_mode)
+    return config
+
+
+def parse_config(
+    config: Union[dict[str, Any], str], inplace: bool = False
+) -> SqsConfiguration:
+    """
+    Parse the configuration dictionary into a SqsConfiguration object.
+
+    Args:
+        config (dict[str, Any]): Configuration dictionary.
+        inplace (bool, optional): If `True`, return a modified version of the input dictionary.
+
+    Returns:
+        SqsConfiguration: Parsed configuration object.
+    """
+    return _parse_config(_preprocess_config(config, inplace))  # type: ignore[return-value]
+
+
+def parse_sweep(
+    config: Union[dict[str, Any], str], inplace: bool = False
+) -> Union[list[SqsConfiguration], ParseError]:
+    """
+    Parse a configuration dictionary with a ``sweep`` key into one SqsConfiguration object per
+    composition listed in the sweep.
 
-    return _parse_config(config)  # type: ignore[return-value]
+    Args:
+        config (dict[str, Any] | str): Configuration dictionary.
+        inplace (bool, optional): If `True`, return a modified version of the input dictionary.
+
+    Returns:
+        list[SqsConfiguration] | ParseError: The parsed configurations in the order of the sweep.
+    """
+    return _parse_sweep(_preprocess_config(config, inplace))  # type: ignore[return-value]
 
 
 def optimize(
@@ -166,3 +233,68 @@ def optimize(
         else parse_config(config)
     )
     return _optimize(c, log_level=level, callback=callback)
+
+
+def sweep(
+    config: Union[dict[str, Any], list[SqsConfiguration], str],
+    level: LogLevel = LogLevel.warn,
+    callback: Optional[SqsCallback] = None,
+) -> list[SqsResultPack]:
+    """
+    Optimize each composition of a sweep. The compositions are run one after another on the same
+    thread pool, and the pairs of the structure are computed only once.
+
+    Args:
+        config (dict[str, Any] | list[SqsConfiguration] | str): A configuration with a ``sweep``
+            key, or the configurations returned by `parse_sweep`.
+        level (LogLevel): The logging level for the optimization process. Defaults to `LogLevel.warn`.
+        callback (SqsCallback | None): A callback function to monitor the optimization progress. Defaults to `None`.
+
+    Returns:
+        list[SqsResultPack]: The result of each composition, in the order of the sweep.
+    """
+    configs = config if isinstance(config, list) else parse_sweep(config)
+    if isinstance(configs, ParseError):
+        raise ValueError(f"Invalid sweep ({configs.key}): {configs.msg}")
+    return _sweep(configs, log_level=level, callback=callback)
+
+
+def resume(
+    checkpoint: str,
+    level: LogLevel = LogLevel.warn,
+    callback: Optional[SqsCallback] = None,
+) -> SqsResultPack:
+    """
+    Continue an interrupted optimization from a checkpoint file. Checkpoints are written
+    periodically if the ``checkpoint`` parameter is set in the configuration.
+
+    Args:
+        checkpoint (str): Path to the checkpoint file.
+        level (LogLevel): The logging level for the optimization process. Defaults to `LogLevel.warn`.
+        callback (SqsCallback | None): A callback function to monitor the optimization progress. Defaults to `None`.
+
+    Returns:
+        SqsResultPack: The result of the optimization process.
+    """
+    return _resume(checkpoint, log_level=level, callback=callback)
+
+
+def rescore(
+    pack: SqsResultPack, params: Union[dict[str, Any], str]
+) -> Union[SqsResultPack, ParseError]:
+    """
+    Rank the results of a previous run under new parameters of the objective function, without
+    running the optimization again. Only ``shell_weights``, ``pair_weights``, ``prefactors`` and
+    ``target_objective`` can be changed. If ``shell_weights`` are given, the other parameters are
+    recomputed unless they are specified as well.
+
+    Args:
+        pack (SqsResultPack): The results to rescore.
+        params (dict[str, Any] | str): The new parameters of the objective function, either as
+            dictionary or as JSON string.
+
+    Returns:
+        SqsResultPack | ParseError: The results ranked by their new objective, or the error if
+            the parameters are invalid.
+    """
+    return pack.rescore(params)  # type: ignore[return-value]
@@ -8,7 +8,14 @@ from typing import Optional
 import click
 
 from .._adapters import available_formats, read, write
-from ..core import Atom, LogLevel, Prec, load_result_pack
+from ..core import (
+    Atom,
+    LogLevel,
+    ParseError,
+    Prec,
+    load_result_pack,
+    merge_result_packs,
+)
 from ..templates import load_templates
 from ._link import link as _link
 from ._run import run_optimization
@@ -159,15 +166,36 @@ def template(name: Optional[str]) -> None:
     default="sqs.mpack",
     help="The output file from which structures should be exported from",
 )
+@click.option(
+    "--variant",
+    type=click.IntRange(min=0),
+    default=None,
+    help="use the results of the n-th objective variant instead of the main objective",
+)
 @click.pass_context
-def output(ctx: click.Context, output: str) -> None:
+def output(ctx: click.Context, output: str, variant: Optional[int]) -> None:
     ctx.obj = output
+    ctx.meta["variant"] = variant
+
+
+def _load_output(output: click.File):
+    pack = load_result_pack(output.read(), prec=Prec.double)
+    variant = click.get_current_context().meta.get("variant")
+    if variant is None:
+        return pack
+    if not (0 <= variant < len(pack.variants)):
+        render_error(
+            f"Invalid variant index '{variant}'",
+            info=f"the result file contains {len(pack.variants)} objective variants",
+        )
+        raise SystemExit(1)
+    return pack.variants[variant]
 
 
 @output.command(name="list")
 @click.pass_obj
 def _list(output: click.File) -> None:
-    pack = load_result_pack(output.read(), prec=Prec.double)
+    pack = _load_output(output)
     buf = io.StringIO()
     print_ = functools.partial(print, file=buf)
     print_(
@@ -222,7 +250,7 @@ def _list(output: click.File) -> None:
 def structure(
     output: click.File, objective: tuple[int, ...], index: tuple[int, ...], fmt: str
 ) -> None:
-    pack = load_result_pack(output.read(), prec=Prec.double)
+    pack = _load_output(output)
     for obj in objective:
         if not (0 <= obj < pack.num_objectives()):
             render_error(
@@ -244,7 +272,7 @@ def structure(
 @output.command(name="config")
 @click.pass_obj
 def config(output: click.File) -> None:
-    pack = load_result_pack(output.read(), prec=Prec.double)
+    pack = _load_output(output)
 
     parsed = json.loads(pack.config.json())
     # fixup composition
@@ -263,6 +291,60 @@ def config(output: click.File) -> None:
         json.dump(parsed, config_file, indent=2)
 
 
+@cli.command(
+    name="rescore",
+    help="rank the results of a SQS optimization run under new parameters of the objective function",
+)
+@click.argument("params", type=click.File(mode="r"))
+@click.option(
+    "--output",
+    "-o",
+    type=click.File(mode="rb"),
+    default="sqs.mpack",
+    help="The output file whose results should be rescored",
+)
+def rescore(params: click.File, output: click.File) -> None:
+    pack = load_result_pack(output.read(), prec=Prec.double)
+    rescored = pack.rescore(params.read())
+    if isinstance(rescored, ParseError):
+        render_error(rescored.msg, parameter=rescored.key)
+        return
+
+    stem, ext = os.path.splitext(output.name)
+    with open(f"{stem}.rescored.mpack", "wb") as output_file:
+        output_file.write(rescored.bytes())
+
+
+@cli.command(
+    name="merge",
+    help="combine the result packs of independent runs, e.g. with different seeds",
+)
+@click.argument("shards", nargs=-1, required=True, type=click.Path(exists=True, dir_okay=False))
+@click.option(
+    "--write",
+    "-w",
+    type=click.Path(dir_okay=False, writable=True),
+    default="sqs.merged.mpack",
+    help="The file to write the merged results to",
+)
+@click.option(
+    "--keep",
+    "-k",
+    type=click.IntRange(min=1),
+    default=None,
+    help="The number of objectives to keep, defaults to the value of the first shard",
+)
+def merge(shards: tuple[str, ...], write: str, keep: Optional[int]) -> None:
+    try:
+        merged = merge_result_packs(list(shards), keep=keep, prec=Prec.double)
+    except (ValueError, RuntimeError) as e:
+        render_error(str(e))
+        return
+
+    with open(write, "wb") as output_file:
+        output_file.write(merged.bytes())
+
+
 @cli.command(
     name="link",
     help="create a shareable link for the configuration file on https://sqsgen.gehringer.tech",
@@ -2,6 +2,7 @@ from typing import Callable, Union
 
 from ._core import (
     Atom,
+    DeduplicationMode,
     IterationMode,
     LogLevel,
     ParseError,
@@ -16,6 +17,10 @@ from ._core import (
     SqsResultPackInteractFloat,
     SqsResultPackSplitDouble,
     SqsResultPackSplitFloat,
+    SqsResultPackViewInteractDouble,
+    SqsResultPackViewInteractFloat,
+    SqsResultPackViewSplitDouble,
+    SqsResultPackViewSplitFloat,
     SqsResultSplitDouble,
     SqsResultSplitFloat,
     StructureDouble,
@@ -26,11 +31,16 @@ from ._core import (
     double,
     interact,
     load_result_pack,
+    merge_result_packs,
+    open_result_pack,
     optimize,
     parse_config,
+    parse_sweep,
     random,
+    resume,
     single,
     split,
+    sweep,
     systematic,
 )
 from ._core import (
@@ -57,9 +67,16 @@ SqsCallback = Callable[[SqsCallbackContext], None]
 
 SqsResult = Union[SqsResultInteract, SqsResultSplit]
 SqsResultPack = Union[SqsResultPackInteract, SqsResultPackSplit]
+SqsResultPackView = Union[
+    SqsResultPackViewInteractFloat,
+    SqsResultPackViewInteractDouble,
+    SqsResultPackViewSplitFloat,
+    SqsResultPackViewSplitDouble,
+]
 
 __all__ = [
     "Atom",
+    "DeduplicationMode",
     "IterationMode",
     "LogLevel",
     "ParseError",
@@ -80,6 +97,11 @@ __all__ = [
     "SqsResultPackInteractFloat",
     "SqsResultPackSplitDouble",
     "SqsResultPackSplitFloat",
+    "SqsResultPackView",
+    "SqsResultPackViewInteractDouble",
+    "SqsResultPackViewInteractFloat",
+    "SqsResultPackViewSplitDouble",
+    "SqsResultPackViewSplitFloat",
     "SqsResultSplit",
     "SqsResultSplit",
     "SqsResultSplitDouble",
@@ -93,10 +115,15 @@ __all__ = [
     "double",
     "interact",
     "load_result_pack",
+    "merge_result_packs",
+    "open_result_pack",
     "optimize",
     "parse_config",
+    "parse_sweep",
     "random",
+    "resume",
     "single",
     "split",
+    "sweep",
     "systematic",
 ]
@@ -10,6 +10,7 @@ comm: Timing
 debug: LogLevel
 double: Prec
 error: LogLevel
+exact: DeduplicationMode
 info: LogLevel
 interact: SublatticeMode
 json_ase: StructureFormat
@@ -22,9 +23,11 @@ poscar: StructureFormat
 random: IterationMode
 single: Prec
 split: SublatticeMode
+symmetry: DeduplicationMode
 systematic: IterationMode
 total: Timing
 trace: LogLevel
+translations: DeduplicationMode
 undefined: Timing
 warn: LogLevel
 
@@ -60,6 +63,23 @@ class AtomPair:
     @property
     def shell(self) -> int: ...
 
+class DeduplicationMode:
+    __members__: ClassVar[dict] = ...  # read-only
+    __entries: ClassVar[dict] = ...
+    exact: ClassVar[DeduplicationMode] = ...
+    symmetry: ClassVar[DeduplicationMode] = ...
+    translations: ClassVar[DeduplicationMode] = ...
+    def __init__(self, value: int) -> None: ...
+    def __eq__(self, other: object) -> bool: ...
+    def __hash__(self) -> int: ...
+    def __index__(self) -> int: ...
+    def __int__(self) -> int: ...
+    def __ne__(self, other: object) -> bool: ...
+    @property
+    def name(self) -> str: ...
+    @property
+    def value(self) -> int: ...
+
 class Indices:
     def __init__(self) -> None: ...
     def add(self, value: int) -> None: ...
@@ -110,6 +130,20 @@ class LogLevel:
     @property
     def value(self) -> int: ...
 
+class ObjectiveVariantDouble:
+    pair_weights: Incomplete
+    prefactors: Incomplete
+    shell_weights: list[dict[int, float]]
+    target_objective: Incomplete
+    def __init__(self, *args, **kwargs) -> None: ...
+
+class ObjectiveVariantFloat:
+    pair_weights: Incomplete
+    prefactors: Incomplete
+    shell_weights: list[dict[int, float]]
+    target_objective: Incomplete
+    def __init__(self, *args, **kwargs) -> None: ...
+
 class ParseError:
     def __init__(self, *args, **kwargs) -> None: ...
     @property
@@ -214,18 +248,30 @@ class SqsCallbackContextFloat:
     def statistics(self) -> SqsStatisticsDataFloat: ...
 
 class SqsConfigurationDouble:
+    checkpoint: str | None
+    checkpoint_interval: int
+    geometry_cache: str | None
+    spill: str | None
+    spill_limit: int
     chunk_size: int
+    compact_results: bool
     composition: list[Sublattice]
+    deduplication: DeduplicationMode
     iteration_mode: IterationMode
     iterations: int | None
+    max_stagnation: int | None
+    max_time: int | None
+    objective_threshold: float | None
     pair_weights: Incomplete
     prefactors: Incomplete
     shell_radii: list[list[float]]
     shell_weights: list[dict[int, float]]
     seed: list[int | None] | None
+    shared_memory: bool
     sublattice_mode: SublatticeMode
     target_objective: Incomplete
     thread_config: list[int]
+    variants: list[ObjectiveVariantDouble]
     def __init__(self, *args, **kwargs) -> None: ...
     def bytes(self) -> bytes: ...
     @staticmethod
@@ -234,18 +280,30 @@ class SqsConfigurationDouble:
     def structure(self) -> StructureDouble: ...
 
 class SqsConfigurationFloat:
+    checkpoint: str | None
+    checkpoint_interval: int
+    geometry_cache: str | None
+    spill: str | None
+    spill_limit: int
     chunk_size: int
+    compact_results: bool
     composition: list[Sublattice]
+    deduplication: DeduplicationMode
     iteration_mode: IterationMode
     iterations: int | None
+    max_stagnation: int | None
+    max_time: int | None
+    objective_threshold: float | None
     pair_weights: Incomplete
     prefactors: Incomplete
     shell_radii: list[list[float]]
     shell_weights: list[dict[int, float]]
     seed: list[int | None] | None
+    shared_memory: bool
     sublattice_mode: SublatticeMode
     target_objective: Incomplete
     thread_config: list[int]
+    variants: list[ObjectiveVariantFloat]
     def __init__(self, *args, **kwargs) -> None: ...
     def bytes(self) -> bytes: ...
     @staticmethod
@@ -270,6 +328,8 @@ class SqsResultInteractDouble:
     def sro(self, i: str, j: str) -> list[SroParameterDouble]: ...
     def structure(self) -> StructureDouble: ...
     @property
+    def iteration(self) -> int: ...
+    @property
     def objective(self) -> float: ...
     @property
     def species(self) -> list[int]: ...
@@ -291,6 +351,8 @@ class SqsResultInteractFloat:
     def sro(self, i: str, j: str) -> list[SroParameterFloat]: ...
     def structure(self) -> StructureFloat: ...
     @property
+    def iteration(self) -> int: ...
+    @property
     def objective(self) -> float: ...
     @property
     def species(self) -> list[int]: ...
@@ -303,6 +365,7 @@ class SqsResultPackInteractDouble:
     def from_bytes(bytes: str) -> SqsResultPackInteractDouble: ...
     def num_objectives(self) -> int: ...
     def num_results(self) -> int: ...
+    def rescore(self, *args, **kwargs) -> SqsResultPackInteractDouble | ParseError: ...
     def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultInteractDouble]]: ...
     def __iter__(self) -> Iterator[tuple[float, list[SqsResultInteractDouble]]]: ...
     def __len__(self) -> int: ...
@@ -310,6 +373,8 @@ class SqsResultPackInteractDouble:
     def config(self) -> SqsConfigurationDouble: ...
     @property
     def statistics(self) -> SqsStatisticsDataDouble: ...
+    @property
+    def variants(self) -> list[SqsResultPackInteractDouble]: ...
 
 class SqsResultPackInteractFloat:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -319,6 +384,7 @@ class SqsResultPackInteractFloat:
     def from_bytes(bytes: str) -> SqsResultPackInteractFloat: ...
     def num_objectives(self) -> int: ...
     def num_results(self) -> int: ...
+    def rescore(self, *args, **kwargs) -> SqsResultPackInteractFloat | ParseError: ...
     def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultInteractFloat]]: ...
     def __iter__(self) -> Iterator[tuple[float, list[SqsResultInteractFloat]]]: ...
     def __len__(self) -> int: ...
@@ -326,6 +392,8 @@ class SqsResultPackInteractFloat:
     def config(self) -> SqsConfigurationFloat: ...
     @property
     def statistics(self) -> SqsStatisticsDataFloat: ...
+    @property
+    def variants(self) -> list[SqsResultPackInteractFloat]: ...
 
 class SqsResultPackSplitDouble:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -335,6 +403,7 @@ class SqsResultPackSplitDouble:
     def from_bytes(bytes: str) -> SqsResultPackSplitDouble: ...
     def num_objectives(self) -> int: ...
     def num_results(self) -> int: ...
+    def rescore(self, *args, **kwargs) -> SqsResultPackSplitDouble | ParseError: ...
     def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultSplitDouble]]: ...
     def __iter__(self) -> Iterator[tuple[float, list[SqsResultSplitDouble]]]: ...
     def __len__(self) -> int: ...
@@ -342,6 +411,8 @@ class SqsResultPackSplitDouble:
     def config(self) -> SqsConfigurationDouble: ...
     @property
     def statistics(self) -> SqsStatisticsDataDouble: ...
+    @property
+    def variants(self) -> list[SqsResultPackSplitDouble]: ...
 
 class SqsResultPackSplitFloat:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -351,6 +422,7 @@ class SqsResultPackSplitFloat:
     def from_bytes(bytes: str) -> SqsResultPackSplitFloat: ...
     def num_objectives(self) -> int: ...
     def num_results(self) -> int: ...
+    def rescore(self, *args, **kwargs) -> SqsResultPackSplitFloat | ParseError: ...
     def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultSplitFloat]]: ...
     def __iter__(self) -> Iterator[tuple[float, list[SqsResultSplitFloat]]]: ...
     def __len__(self) -> int: ...
@@ -358,6 +430,84 @@ class SqsResultPackSplitFloat:
     def config(self) -> SqsConfigurationFloat: ...
     @property
     def statistics(self) -> SqsStatisticsDataFloat: ...
+    @property
+    def variants(self) -> list[SqsResultPackSplitFloat]: ...
+
+class SqsResultPackViewInteractDouble:
+    def __init__(self, *args, **kwargs) -> None: ...
+    def load(self) -> SqsResultPackInteractDouble: ...
+    def num_objectives(self) -> int: ...
+    @overload
+    def num_results(self) -> int: ...
+    @overload
+    def num_results(self, objective: int) -> int: ...
+    def num_variants(self) -> int: ...
+    def objective(self, objective: int) -> float: ...
+    def result(self, objective: int, index: int) -> SqsResultInteractDouble: ...
+    def variant(self, index: int) -> SqsResultPackViewInteractDouble: ...
+    def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultInteractDouble]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def config(self) -> SqsConfigurationDouble: ...
+    @property
+    def statistics(self) -> SqsStatisticsDataDouble: ...
+
+class SqsResultPackViewInteractFloat:
+    def __init__(self, *args, **kwargs) -> None: ...
+    def load(self) -> SqsResultPackInteractFloat: ...
+    def num_objectives(self) -> int: ...
+    @overload
+    def num_results(self) -> int: ...
+    @overload
+    def num_results(self, objective: int) -> int: ...
+    def num_variants(self) -> int: ...
+    def objective(self, objective: int) -> float: ...
+    def result(self, objective: int, index: int) -> SqsResultInteractFloat: ...
+    def variant(self, index: int) -> SqsResultPackViewInteractFloat: ...
+    def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultInteractFloat]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def config(self) -> SqsConfigurationFloat: ...
+    @property
+    def statistics(self) -> SqsStatisticsDataFloat: ...
+
+class SqsResultPackViewSplitDouble:
+    def __init__(self, *args, **kwargs) -> None: ...
+    def load(self) -> SqsResultPackSplitDouble: ...
+    def num_objectives(self) -> int: ...
+    @overload
+    def num_results(self) -> int: ...
+    @overload
+    def num_results(self, objective: int) -> int: ...
+    def num_variants(self) -> int: ...
+    def objective(self, objective: int) -> float: ...
+    def result(self, objective: int, index: int) -> SqsResultSplitDouble: ...
+    def variant(self, index: int) -> SqsResultPackViewSplitDouble: ...
+    def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultSplitDouble]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def config(self) -> SqsConfigurationDouble: ...
+    @property
+    def statistics(self) -> SqsStatisticsDataDouble: ...
+
+class SqsResultPackViewSplitFloat:
+    def __init__(self, *args, **kwargs) -> None: ...
+    def load(self) -> SqsResultPackSplitFloat: ...
+    def num_objectives(self) -> int: ...
+    @overload
+    def num_results(self) -> int: ...
+    @overload
+    def num_results(self, objective: int) -> int: ...
+    def num_variants(self) -> int: ...
+    def objective(self, objective: int) -> float: ...
+    def result(self, objective: int, index: int) -> SqsResultSplitFloat: ...
+    def variant(self, index: int) -> SqsResultPackViewSplitFloat: ...
+    def __getitem__(self, arg0: int) -> tuple[float, list[SqsResultSplitFloat]]: ...
+    def __len__(self) -> int: ...
+    @property
+    def config(self) -> SqsConfigurationFloat: ...
+    @property
+    def statistics(self) -> SqsStatisticsDataFloat: ...
 
 class SqsResultSplitDouble:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -509,6 +659,7 @@ class StructureFormat:
     json_pymatgen: ClassVar[StructureFormat] = ...
     json_sqsgen: ClassVar[StructureFormat] = ...
     poscar: ClassVar[StructureFormat] = ...
+    xyz: ClassVar[StructureFormat] = ...
     def __init__(self, value: int) -> None: ...
     def __eq__(self, other: object) -> bool: ...
     def __hash__(self) -> int: ...
@@ -561,5 +712,10 @@ class Timing:
     def value(self) -> int: ...
 
 def load_result_pack(data: str, prec: Prec = ...) -> SqsResultPackSplitFloat | SqsResultPackSplitDouble | SqsResultPackInteractFloat | SqsResultPackInteractDouble: ...
+def merge_result_packs(paths: list[str], keep: int | None = ..., prec: Prec = ...) -> SqsResultPackSplitFloat | SqsResultPackSplitDouble | SqsResultPackInteractFloat | SqsResultPackInteractDouble: ...
+def open_result_pack(path: str, prec: Prec = ...) -> SqsResultPackViewSplitFloat | SqsResultPackViewSplitDouble | SqsResultPackViewInteractFloat | SqsResultPackViewInteractDouble: ...
 def optimize(*args, **kwargs): ...
 def parse_config(*args, **kwargs): ...
+def parse_sweep(*args, **kwargs): ...
+def resume(checkpoint: str, log_level: LogLevel = ..., callback: SqsCallback | None = ...) -> SqsResultPackSplitFloat | SqsResultPackSplitDouble | SqsResultPackInteractFloat | SqsResultPackInteractDouble: ...
+def sweep(configs: list[SqsConfigurationFloat] | list[SqsConfigurationDouble], log_level: LogLevel = ..., callback: SqsCallback | None = ...) -> list[SqsResultPackSplitFloat | SqsResultPackSplitDouble | SqsResultPackInteractFloat | SqsResultPackInteractDouble]: ...
@@ -8,8 +8,9 @@ from typing import NamedTuple, TypeVar
 import numpy as np
 import pytest
 
-from sqsgenerator import optimize
+from sqsgenerator import optimize, parse_sweep, rescore, sweep
 from sqsgenerator.core import (
+    ParseError,
     Prec,
     SqsConfiguration,
     SqsResult,
@@ -318,14 +319,175 @@ def test_random_seed_reproducible(prec):
 
 
 @pytest.mark.parametrize("prec", [single, double])
-def test_random_seed_with_multiple_threads_fails(prec):
-    from sqsgenerator.core._core import ParseError
+@pytest.mark.parametrize("mode", [systematic, random])
+def test_compact_results(prec, mode):
+    def solutions(compact):
+        settings = default_settings(prec)
+        settings["iteration_mode"] = mode
+        if mode == random:
+            settings["iterations"] = 500
+            settings["seed"] = 42
+        settings["compact_results"] = compact
+        # a random run might visit a configuration twice, compact results are not deduplicated
+        return {
+            (
+                round(float(sol.objective), 12),
+                tuple(sol.species),
+                sol.rank(),
+                tuple(np.round(sol.sro(), 12).flat),
+            )
+            for _, result_set in optimize(parse_config(settings))
+            for sol in result_set
+        }
+
+    assert solutions(True) == solutions(False)
+
+
+@pytest.mark.parametrize("prec", [single, double])
+def test_random_seed_independent_of_threads(prec):
+    def solutions(thread_config, chunk_size):
+        settings = default_settings(prec)
+        settings["iteration_mode"] = random
+        settings["iterations"] = 500
+        settings["seed"] = 42
+        settings["thread_config"] = thread_config
+        settings["chunk_size"] = chunk_size
+        objective, best = next(iter(optimize(parse_config(settings))))
+        return round(float(objective), 12), collections.Counter(
+            tuple(sol.structure().species) for sol in best
+        )
+
+    assert solutions(1, 500) == solutions(4, 17)
+
 
+@pytest.mark.parametrize("prec", [single, double])
+def test_deduplication(prec):
+    def solutions(mode):
+        settings = default_settings(prec)
+        settings["deduplication"] = mode
+        return [
+            tuple(sol.species)
+            for _, result_set in optimize(parse_config(settings))
+            for sol in result_set
+        ]
+
+    exact = solutions("exact")
+    translations = solutions("translations")
+    symmetry = solutions("symmetry")
+    assert len(exact) == 12870
+    assert set(translations) <= set(exact)
+    assert set(symmetry) <= set(exact)
+    assert len(symmetry) < len(translations) < len(exact)
+
+    # every site is a lattice point of the supercell, hence defines a translation
+    frac_coords = parse_config(default_settings(prec)).structure().frac_coords
+
+    def wrapped(c):
+        return as_tuple(np.mod(np.round(c, 5), 1.0))
+
+    site_index = {wrapped(c): i for i, c in enumerate(frac_coords)}
+    permutations = [
+        [site_index[wrapped(c + shift - frac_coords[0])] for c in frac_coords]
+        for shift in frac_coords
+    ]
+
+    def orbit(species):
+        images = []
+        for permutation in permutations:
+            image = [0] * len(species)
+            for i, p in enumerate(permutation):
+                image[p] = species[i]
+            images.append(tuple(image))
+        return min(images)
+
+    # exactly one representative of every translation orbit is kept
+    orbits = {orbit(s) for s in translations}
+    assert len(orbits) == len(translations)
+    assert orbits == {orbit(s) for s in exact}
+
+
+@pytest.mark.parametrize("prec", [single, double])
+def test_rescore(prec):
+    # all pair weights vanish, hence every configuration is kept
     settings = default_settings(prec)
-    settings["iteration_mode"] = random
-    settings["iterations"] = 500
-    settings["seed"] = 42
-    settings["thread_config"] = 4
+    results = optimize(parse_config(settings))
+
+    unchanged = rescore(results, {})
+    assert unchanged.num_results() == results.num_results()
+    assert [objective for objective, _ in unchanged] == [
+        objective for objective, _ in results
+    ]
+
+    shell_weights = {1: 1.0, 2: 0.5}
+    rescored = rescore(results, {"shell_weights": shell_weights})
+    assert rescored.num_results() == results.num_results()
 
+    del settings["pair_weights"]
+    settings["shell_weights"] = shell_weights
+    reference = optimize(parse_config(settings))
+    (best, best_results), (reference_best, reference_results) = rescored[0], reference[0]
+    assert best == pytest.approx(reference_best)
+    assert {tuple(r.species) for r in best_results} == {
+        tuple(r.species) for r in reference_results
+    }
+
+
+@pytest.mark.parametrize("prec", [single, double])
+def test_variants(prec):
+    settings = default_settings(prec)
+    settings["variants"] = [{"pair_weights": 1.0}, {"target_objective": 0.5}]
     config = parse_config(settings)
-    assert isinstance(config, ParseError)
+    assert len(config.variants) == 2
+    results = optimize(config)
+    # the main objective is not affected by the variants
+    assert results.num_results() == config.iterations
+    assert len(results.variants) == 2
+
+    del settings["variants"]
+    for variant, overrides in zip(
+        results.variants, [{"pair_weights": 1.0}, {"target_objective": 0.5}]
+    ):
+        reference = optimize(parse_config(settings | overrides))
+        (best, best_results), (reference_best, reference_results) = (
+            variant[0],
+            reference[0],
+        )
+        assert best == pytest.approx(reference_best)
+        assert variant.statistics.best_objective == pytest.approx(reference_best)
+        assert {tuple(r.species) for r in best_results} == {
+            tuple(r.species) for r in reference_results
+        }
+
+    settings["variants"] = [{"shell_weights": {1: 1.0}}]
+    assert isinstance(parse_config(settings), ParseError)
+
+
+@pytest.mark.parametrize("prec", [single, double])
+def test_sweep(prec):
+    settings = default_settings(prec)
+    del settings["composition"], settings["pair_weights"]
+    compositions = [
+        {"sites": "H", "Ti": 8, "Al": 8},
+        {"sites": "H", "Ti": 4, "Al": 12},
+        {"sites": "H", "Ti": 12, "Al": 4},
+    ]
+    settings["sweep"] = [{"composition": c} for c in compositions]
+    configs = parse_sweep(settings)
+    assert len(configs) == len(compositions)
+    packs = sweep(configs)
+    assert len(packs) == len(compositions)
+
+    del settings["sweep"]
+    for pack, composition in zip(packs, compositions):
+        reference = optimize(settings | {"composition": composition})
+        assert pack.num_results() == reference.num_results()
+        (best, best_results), (reference_best, reference_results) = pack[0], reference[0]
+        assert best == pytest.approx(reference_best)
+        assert {tuple(r.species) for r in best_results} == {
+            tuple(r.species) for r in reference_results
+        }
+
+    settings["composition"] = compositions[0]
+    settings["sweep"] = [{"composition": compositions[1]}]
+    assert isinstance(parse_sweep(settings), ParseError)
+    assert isinstance(parse_config(settings), ParseError)
@@ -0,0 +1,116 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <set>
+
+#include "sqsgen/io/config/combined.h"
+#include "sqsgen/io/mpi.h"
+#include "sqsgen/sqs.h"
+
+namespace sqsgen::testing {
+
+  TEST(ReductionTree, eight_ranks) {
+    using io::mpi::reduction_tree;
+    ASSERT_FALSE(reduction_tree(0, 8).parent.has_value());
+    ASSERT_EQ(reduction_tree(0, 8).children, (std::vector{1, 2, 4}));
+    ASSERT_EQ(reduction_tree(4, 8).parent, 0);
+    ASSERT_EQ(reduction_tree(4, 8).children, (std::vector{5, 6}));
+    ASSERT_EQ(reduction_tree(6, 8).parent, 4);
+    ASSERT_EQ(reduction_tree(6, 8).children, (std::vector{7}));
+    ASSERT_EQ(reduction_tree(7, 8).parent, 6);
+    ASSERT_TRUE(reduction_tree(7, 8).children.empty());
+  }
+
+  TEST(ReductionTree, parents_and_children_agree) {
+    for (int num_ranks = 1; num_ranks <= 37; ++num_ranks) {
+      std::vector<std::vector<int>> children(num_ranks);
+      for (int rank = 0; rank < num_ranks; ++rank) {
+        auto node = io::mpi::reduction_tree(rank, num_ranks);
+        ASSERT_EQ(node.parent.has_value(), rank != 0);
+        if (node.parent.has_value()) {
+          ASSERT_LT(node.parent.value(), rank);
+          children[node.parent.value()].push_back(rank);
+        }
+        // the children with the smallest subtrees come first
+        ASSERT_TRUE(std::ranges::is_sorted(node.children));
+        // every rank reaches the head rank within log2(num_ranks) steps
+        int steps{0};
+        for (auto current = node; current.parent.has_value(); ++steps)
+          current = io::mpi::reduction_tree(current.parent.value(), num_ranks);
+        ASSERT_LE(steps, std::bit_width(static_cast<unsigned>(num_ranks - 1)));
+      }
+      for (int rank = 0; rank < num_ranks; ++rank)
+        ASSERT_EQ(io::mpi::reduction_tree(rank, num_ranks).children, children[rank]);
+    }
+  }
+
+#ifdef WITH_MPI
+  TEST(SharedArray, single_rank) {
+    io::mpi::node_communicator node(mpl::environment::comm_self());
+    ASSERT_EQ(node.size(), 1);
+    ASSERT_TRUE(node.is_leader());
+    std::vector<core::packed_pair> pairs{{0, 1, 0}, {0, 2, 1}, {1, 2, 0}, {2, 3, 1}};
+    io::mpi::shared_array<core::packed_pair> array(node, pairs);
+    ASSERT_EQ(array.size(), pairs.size());
+    for (std::size_t i = 0; i < pairs.size(); ++i) {
+      ASSERT_EQ(array.view()[i].i, pairs[i].i);
+      ASSERT_EQ(array.view()[i].j, pairs[i].j);
+      ASSERT_EQ(array.view()[i].shell, pairs[i].shell);
+    }
+    auto moved{std::move(array)};
+    ASSERT_EQ(moved.size(), pairs.size());
+    ASSERT_EQ(array.size(), 0);
+
+    io::mpi::shared_array<core::packed_pair> empty(node, {});
+    ASSERT_EQ(empty.size(), 0);
+    ASSERT_TRUE(empty.view().empty());
+  }
+
+  /*
+   * Only the node leader computes the pair lists and the bonds between frozen sites. Run with
+   * several ranks, the other ranks must find the same results as with pair lists of their own
+   */
+  TEST(SharedMemory, same_results_as_private_pair_lists) {
+    using pack_t = core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>;
+    const auto run = [](bool shared_memory) {
+      // only half of the sites are mixed, the bonds between the others are static
+      nlohmann::json document{
+          {"structure",
+           {{"lattice", {{4.05, 0, 0}, {0, 4.05, 0}, {0, 0, 4.05}}},
+            {"coords", {{0, 0, 0}, {0, 0.5, 0.5}, {0.5, 0, 0.5}, {0.5, 0.5, 0}}},
+            {"species", {13, 13, 13, 13}},
+            {"supercell", {2, 2, 2}}}},
+          {"composition",
+           {{{"sites", {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}},
+             {"Al", 8},
+             {"Ni", 8}}}},
+          {"iterations", 2000},
+          {"keep", 5},
+          {"seed", {7}},
+          {"prec", "double"},
+          {"thread_config", 1},
+          {"shared_memory", shared_memory}};
+      auto config = io::config::parse_config(document);
+      return std::get<pack_t>(run_optimization(config.result(), log::level::warn));
+    };
+    auto shared = run(true);
+    auto own = run(false);
+    if (mpl::environment::comm_world().rank() != io::mpi::RANK_HEAD) return;
+    ASSERT_EQ(shared.size(), own.size());
+    for (std::size_t o = 0; o < own.size(); ++o) {
+      auto [objective, results] = own.results.at(o);
+      auto [shared_objective, shared_results] = shared.results.at(o);
+      ASSERT_EQ(objective, shared_objective);
+      std::set<configuration_t> expected, actual;
+      for (auto& result : results) expected.insert(result.configuration());
+      for (auto& result : shared_results) actual.insert(result.configuration());
+      ASSERT_EQ(expected, actual);
+    }
+  }
+#endif
+
+}  // namespace sqsgen::testing
@@ -0,0 +1,340 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+
+#include "sqsgen/io/config/combined.h"
+#include "sqsgen/io/export.h"
+#include "sqsgen/io/merge.h"
+#include "sqsgen/io/pack.h"
+#include "sqsgen/io/spill.h"
+#include "sqsgen/sqs.h"
+
+namespace sqsgen::testing {
+  using json = nlohmann::json;
+
+  json fcc_config(json&& parameters) {
+    json config{{"structure",
+                 {{"lattice", {{4.05, 0, 0}, {0, 4.05, 0}, {0, 0, 4.05}}},
+                  {"coords", {{0, 0, 0}, {0, 0.5, 0.5}, {0.5, 0, 0.5}, {0.5, 0.5, 0}}},
+                  {"species", {13, 13, 13, 13}},
+                  {"supercell", {2, 2, 2}}}},
+                {"iterations", 2000},
+                {"keep", 5},
+                {"seed", {7}}};
+    config.update(parameters);
+    return config;
+  }
+
+  // a file name in the temporary directory which is not shared with concurrently running tests
+  std::filesystem::path unique_path(std::string const& extension) {
+    auto const* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    return std::filesystem::temp_directory_path()
+           / format_string("sqsgen-%s-%s-%x%s", info->test_suite_name(), info->name(),
+                           std::random_device{}(), extension);
+  }
+
+  template <class Pack> void assert_same_pack(Pack& expected, Pack& actual) {
+    ASSERT_EQ(actual.size(), expected.size());
+    ASSERT_EQ(actual.num_results(), expected.num_results());
+    ASSERT_EQ(actual.statistics.best_objective, expected.statistics.best_objective);
+    ASSERT_EQ(json(actual.config), json(expected.config));
+    for (auto lhs = expected.begin(), rhs = actual.begin(); lhs != expected.end(); ++lhs, ++rhs) {
+      ASSERT_EQ(std::get<0>(*lhs), std::get<0>(*rhs));
+      ASSERT_EQ(std::get<1>(*lhs).size(), std::get<1>(*rhs).size());
+      // the order of results with the same objective is not preserved
+      std::set<configuration_t> expected_configurations, actual_configurations;
+      for (auto& result : std::get<1>(*lhs)) expected_configurations.insert(result.configuration());
+      for (auto& result : std::get<1>(*rhs)) actual_configurations.insert(result.configuration());
+      ASSERT_EQ(expected_configurations, actual_configurations);
+    }
+    ASSERT_EQ(actual.variants.size(), expected.variants.size());
+    for (std::size_t i = 0; i < expected.variants.size(); ++i)
+      assert_same_pack(expected.variants[i], actual.variants[i]);
+  }
+
+  void assert_roundtrip(json&& document) {
+    auto config = io::config::parse_config(document);
+    ASSERT_FALSE(config.failed()) << config.error().msg;
+    auto pack = run_optimization(config.result(), log::level::warn);
+    std::stringstream buffer;
+    std::visit([&](auto&& p) { io::write_pack(buffer, p); }, pack);
+    auto read = io::read_pack(buffer);
+    std::visit(
+        [&](auto&& p) {
+          using pack_t = std::decay_t<decltype(p)>;
+          ASSERT_TRUE(std::holds_alternative<pack_t>(read));
+          assert_same_pack(p, std::get<pack_t>(read));
+        },
+        pack);
+  }
+
+  TEST(Pack, roundtrip_interact) {
+    assert_roundtrip(fcc_config({{"composition", {{"Al", 16}, {"Ni", 16}}}}));
+  }
+
+  TEST(Pack, roundtrip_compact_with_variant) {
+    assert_roundtrip(fcc_config({{"composition", {{"Al", 16}, {"Ni", 16}}},
+                                 {"compact_results", true},
+                                 {"prec", "double"},
+                                 {"shell_weights", {{"1", 1.0}, {"2", 0.5}}},
+                                 {"variants", {{{"shell_weights", {{"1", 1.0}, {"2", 0.25}}}}}}}));
+  }
+
+  TEST(Pack, roundtrip_split) {
+    assert_roundtrip(fcc_config({{"sublattice_mode", "split"},
+                                 {"seed", {7, 11}},
+                                 {"composition",
+                                  {{{"sites", {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}},
+                                    {"Al", 8},
+                                    {"Ni", 8}},
+                                   {{"sites", {16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28,
+                                               29, 30, 31}},
+                                    {"Cu", 8},
+                                    {"Fe", 8}}}}}));
+  }
+
+  TEST(Pack, lazy_view) {
+    auto config = io::config::parse_config(
+        fcc_config({{"composition", {{"Al", 16}, {"Ni", 16}}},
+                    {"prec", "double"},
+                    {"shell_weights", {{"1", 1.0}, {"2", 0.5}}},
+                    {"variants", {{{"shell_weights", {{"1", 1.0}, {"2", 0.25}}}}}}}));
+    ASSERT_FALSE(config.failed()) << config.error().msg;
+    auto pack = std::get<core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>>(
+        run_optimization(config.result(), log::level::warn));
+    auto view = std::get<io::pack_view<double, SUBLATTICE_MODE_INTERACT>>(io::make_view(pack));
+
+    ASSERT_EQ(view.size(), pack.size());
+    ASSERT_EQ(view.num_results(), pack.num_results());
+    ASSERT_EQ(view.num_variants(), pack.variants.size());
+    ASSERT_EQ(json(view.config()), json(pack.config));
+    for (std::size_t o = 0; o < pack.size(); ++o) {
+      auto [objective, results] = pack.results.at(o);
+      ASSERT_EQ(view.objective(o), objective);
+      ASSERT_EQ(view.num_results(o), results.size());
+      std::set<configuration_t> expected, actual;
+      for (auto& result : results) expected.insert(result.configuration());
+      for (std::size_t i = 0; i < view.num_results(o); ++i) {
+        auto result = view.result(o, i);
+        ASSERT_EQ(result.objective, objective);
+        ASSERT_EQ(result.structure().size(), pack.config.structure.structure().size());
+        actual.insert(result.configuration());
+      }
+      ASSERT_EQ(expected, actual);
+    }
+    ASSERT_EQ(view.variant(0).size(), pack.variants.front().size());
+    ASSERT_THROW(view.result(pack.size(), 0), std::out_of_range);
+    ASSERT_THROW(view.variant(1), std::out_of_range);
+  }
+
+  TEST(Pack, rejects_msgpack) {
+    std::stringstream buffer;
+    auto bytes = json::to_msgpack(json{{"config", json::object()}});
+    buffer.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    ASSERT_THROW(io::read_pack(buffer), std::invalid_argument);
+  }
+
+  TEST(Export, parallel_frames_and_tar) {
+    auto config = io::config::parse_config(
+        fcc_config({{"composition", {{"Al", 16}, {"Ni", 16}}}, {"prec", "double"}}));
+    ASSERT_FALSE(config.failed()) << config.error().msg;
+    auto pack = std::get<core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>>(
+        run_optimization(config.result(), log::level::warn));
+    auto view = std::get<io::pack_view<double, SUBLATTICE_MODE_INTERACT>>(io::make_view(pack));
+    auto count = view.num_results(0);
+    auto texts = io::format_structures(
+        count, [&](std::size_t i) { return view.result(0, i).structure(); }, STRUCTURE_FORMAT_XYZ,
+        4);
+    ASSERT_EQ(texts.size(), count);
+    for (std::size_t i = 0; i < count; ++i) {
+      ASSERT_EQ(texts[i], io::format(view.result(0, i).structure(), STRUCTURE_FORMAT_XYZ));
+      ASSERT_TRUE(texts[i].starts_with("32\n"));
+    }
+
+    std::stringstream frames;
+    io::write_frames(frames, texts);
+    ASSERT_EQ(frames.str().size(), count * texts.front().size());
+
+    std::vector<std::string> names(count, "structure.xyz");
+    std::stringstream archive;
+    io::write_tar(archive, names, texts);
+    auto bytes = archive.str();
+    ASSERT_EQ(bytes.size() % 512, 0);
+    // the checksum of the first header is the sum of its bytes, with blanks as checksum
+    auto header = bytes.substr(0, 512);
+    auto stored = std::stoul(header.substr(148, 6), nullptr, 8);
+    std::fill_n(header.begin() + 148, 8, ' ');
+    unsigned long checksum{0};
+    for (auto c : header) checksum += static_cast<unsigned char>(c);
+    ASSERT_EQ(stored, checksum);
+    ASSERT_EQ(bytes.substr(512, texts.front().size()), texts.front());
+  }
+
+  TEST(Merge, shards) {
+    using pack_t = core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>;
+    const auto run = [](json&& parameters) {
+      auto config = io::config::parse_config(fcc_config(std::move(parameters)));
+      return std::get<pack_t>(run_optimization(config.result(), log::level::warn));
+    };
+    auto composition = json{{"Al", 16}, {"Ni", 16}};
+    auto first = run({{"composition", composition}, {"prec", "double"}, {"keep", 3}});
+    auto second = run({{"composition", composition},
+                       {"prec", "double"},
+                       {"keep", 3},
+                       {"seed", {11}},
+                       {"compact_results", true}});
+    const auto merge = [](std::vector<io::pack_view_t> shards, std::optional<std::size_t> keep
+                                                                = std::nullopt) {
+      return std::get<pack_t>(io::merge_packs(
+          shards.size(), [&](std::size_t i) { return shards[i]; }, keep));
+    };
+
+    // merging a shard with itself removes all duplicates, only the keep best objectives remain
+    auto self = merge({io::make_view(first), io::make_view(first)});
+    ASSERT_EQ(self.size(), 3);
+    ASSERT_EQ(self.statistics.finished, 2 * first.statistics.finished);
+    for (std::size_t o = 0; o < self.size(); ++o) {
+      auto [objective, results] = first.results.at(o);
+      auto [self_objective, self_results] = self.results.at(o);
+      ASSERT_EQ(objective, self_objective);
+      std::set<configuration_t> expected, actual;
+      for (auto& result : results) expected.insert(result.configuration());
+      for (auto& result : self_results) actual.insert(result.configuration());
+      ASSERT_EQ(expected, actual);
+    }
+
+    auto merged = merge({io::make_view(first), io::make_view(second)});
+    ASSERT_FALSE(merged.config.compact_results);
+    ASSERT_EQ(merged.size(), 3);
+    ASSERT_EQ(merged.statistics.finished, first.statistics.finished + second.statistics.finished);
+    std::set<configuration_t> expected, actual;
+    for (auto& [objective, results] : first)
+      if (objective <= std::get<0>(merged.results.at(2)))
+        for (auto& result : results) expected.insert(result.configuration());
+    for (auto& [objective, results] : merged)
+      for (auto& result : results) {
+        ASSERT_FALSE(result.compact());
+        actual.insert(result.configuration());
+      }
+    ASSERT_TRUE(std::ranges::includes(actual, expected));
+    ASSERT_EQ(merge({io::make_view(first), io::make_view(second)}, 1).size(), 1);
+
+    auto other = run({{"composition", {{"Al", 8}, {"Ni", 24}}}, {"prec", "double"}});
+    ASSERT_THROW(merge({io::make_view(first), io::make_view(other)}), std::invalid_argument);
+  }
+
+  TEST(Spill, compacts_to_pack) {
+    using pack_t = core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>;
+    auto path = std::filesystem::temp_directory_path() / "sqsgen-test.spill";
+    const auto run = [](json&& parameters) {
+      parameters.update({{"composition", {{"Al", 16}, {"Ni", 16}}},
+                         {"prec", "double"},
+                         {"keep", 3},
+                         {"thread_config", 1}});
+      auto config = io::config::parse_config(fcc_config(std::move(parameters)));
+      return std::get<pack_t>(run_optimization(config.result(), log::level::warn));
+    };
+    auto reference = run(json::object());
+    // a single result is held in memory, all others are read back from the file
+    auto spilled = run({{"spill", path.string()}, {"spill_limit", 1}});
+    ASSERT_EQ(spilled.size(), 3);
+    for (std::size_t o = 0; o < spilled.size(); ++o) {
+      auto [objective, results] = reference.results.at(o);
+      auto [spilled_objective, spilled_results] = spilled.results.at(o);
+      ASSERT_EQ(objective, spilled_objective);
+      std::set<configuration_t> expected, actual;
+      for (auto& result : results) expected.insert(result.configuration());
+      for (auto& result : spilled_results) actual.insert(result.configuration());
+      ASSERT_EQ(expected, actual);
+    }
+
+    const auto read = [&] {
+      return io::read_spill<double, SUBLATTICE_MODE_INTERACT>(path, [](auto&&) {});
+    };
+    auto count = read();
+    ASSERT_GE(count, spilled.num_results());
+    // a result cut off by a killed job is skipped
+    std::ofstream(path, std::ios::binary | std::ios::app).write("\x10\0\0\0abc", 7);
+    ASSERT_EQ(read(), count);
+    std::filesystem::remove(path);
+  }
+
+  TEST(Checkpoint, resume_skips_finished_chunks) {
+    using pack_t = core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>;
+    using checkpoint_t = core::sqs_checkpoint<double, SUBLATTICE_MODE_INTERACT>;
+    auto path = unique_path(".checkpoint");
+    // a single thread evaluates the chunks in order, hence the run is reproducible
+    auto config = io::config::parse_config(fcc_config({{"composition", {{"Al", 16}, {"Ni", 16}}},
+                                                       {"prec", "double"},
+                                                       {"thread_config", 1},
+                                                       {"chunk_size", 100},
+                                                       {"checkpoint", path.string()}}));
+    ASSERT_FALSE(config.failed()) << config.error().msg;
+    auto full = std::get<pack_t>(run_optimization(config.result(), log::level::warn));
+
+    // pretend the run was killed after half of the chunks were evaluated
+    auto checkpoint = std::get<checkpoint_t>(io::read_checkpoint(path));
+    ASSERT_EQ(checkpoint.finished.size(), 20);
+    std::ranges::sort(checkpoint.finished);
+    checkpoint.finished.resize(10);
+    auto last = checkpoint.finished.back().second;
+    std::erase_if(checkpoint.results, [&](auto const& result) { return result.iteration >= last; });
+    ASSERT_FALSE(checkpoint.results.empty());
+    checkpoint.statistics.finished = last;
+    io::write_checkpoint(path, checkpoint);
+
+    auto resumed =
+        std::get<pack_t>(resume_optimization(io::read_checkpoint(path), log::level::warn));
+    ASSERT_EQ(resumed.statistics.finished, full.statistics.finished);
+    ASSERT_EQ(resumed.size(), full.size());
+    for (std::size_t o = 0; o < full.size(); ++o) {
+      auto [objective, results] = full.results.at(o);
+      auto [resumed_objective, resumed_results] = resumed.results.at(o);
+      ASSERT_EQ(objective, resumed_objective);
+      std::set<configuration_t> expected, actual;
+      for (auto& result : results) expected.insert(result.configuration());
+      for (auto& result : resumed_results) actual.insert(result.configuration());
+      ASSERT_EQ(expected, actual);
+    }
+    std::filesystem::remove(path);
+  }
+
+  TEST(StopRules, stop_before_iterations_are_exhausted) {
+    using pack_t = core::sqs_result_pack<double, SUBLATTICE_MODE_INTERACT>;
+    // without a stopping rule the runs would take hours
+    constexpr iterations_t iterations = 1000000000;
+    const auto run = [&](json&& parameters) {
+      parameters.update({{"composition", {{"Al", 16}, {"Ni", 16}}},
+                         {"prec", "double"},
+                         {"thread_config", 1},
+                         {"chunk_size", 1000},
+                         {"iterations", iterations}});
+      auto config = io::config::parse_config(fcc_config(std::move(parameters)));
+      EXPECT_FALSE(config.failed()) << config.error().msg;
+      return std::get<pack_t>(run_optimization(config.result(), log::level::warn));
+    };
+
+    // the first configuration already reaches the threshold, the chunk is left immediately
+    auto threshold = run({{"objective_threshold", 100.0}});
+    ASSERT_EQ(threshold.statistics.finished, 1000);
+    ASSERT_EQ(threshold.num_results(), 1);
+
+    auto stagnated = run({{"max_stagnation", 10000}});
+    ASSERT_LT(stagnated.statistics.finished, iterations / 1000);
+
+    auto started = std::chrono::steady_clock::now();
+    auto timed = run({{"max_time", 1}});
+    ASSERT_LT(timed.statistics.finished, iterations);
+    ASSERT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(30));
+  }
+
+}  // namespace sqsgen::testing
@@ -0,0 +1,34 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#include <absl/hash/hash.h>
+#include <gtest/gtest.h>
+
+#include "sqsgen/types.h"
+
+namespace sqsgen::testing {
+
+  TEST(PackedVector, roundtrip) {
+    for (specie_t largest : {0, 1, 2, 3, 7, 12, 118}) {
+      configuration_t values(131);
+      for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = static_cast<specie_t>(i * 7 % (largest + 1));
+      packed_configuration_t packed(values);
+      ASSERT_EQ(packed.size(), values.size());
+      ASSERT_EQ(packed.bits(), std::max<int>(1, std::bit_width(largest)));
+      ASSERT_EQ(packed.unpack(), values);
+      for (std::size_t i = 0; i < values.size(); ++i) ASSERT_EQ(packed[i], values[i]);
+    }
+  }
+
+  TEST(PackedVector, hash_and_equality) {
+    configuration_t a{0, 1, 2, 1, 0, 2}, b{0, 1, 2, 1, 2, 0};
+    ASSERT_EQ(packed_configuration_t(a), packed_configuration_t(a));
+    ASSERT_NE(packed_configuration_t(a), packed_configuration_t(b));
+    ASSERT_EQ(absl::Hash<packed_configuration_t>{}(packed_configuration_t(a)),
+              absl::Hash<packed_configuration_t>{}(packed_configuration_t(a)));
+    ASSERT_NE(packed_configuration_t(configuration_t{0, 0}), packed_configuration_t(configuration_t{0}));
+  }
+
+}  // namespace sqsgen::testing
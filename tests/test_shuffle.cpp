@@ -2,6 +2,70 @@
 // Created by Dominik Gehringer on 09.11.24.
 //
 
+#include <gtest/gtest.h>
+
 #include "sqsgen/core/shuffle.h"
 
-namespace sqsgen::testing {}
+namespace sqsgen::testing {
+  using namespace sqsgen::core;
+
+  configuration_t make_configuration(usize_t size) {
+    configuration_t configuration(size);
+    for (usize_t i = 0; i < size; ++i) configuration[i] = static_cast<specie_t>(i % 7);
+    return configuration;
+  }
+
+  TEST(Shuffle, random_stays_within_bounds) {
+    std::vector<bounds_t<usize_t>> bounds{{3, 40}, {40, 41}, {45, 90}};
+    shuffler shuffler(bounds, 42);
+    auto initial = make_configuration(100);
+    auto configuration = initial;
+    for (auto iteration = 0; iteration < 50; ++iteration) {
+      shuffler.shuffle<ITERATION_MODE_RANDOM>(configuration);
+      std::vector<bool> inside(configuration.size(), false);
+      for (auto&& [lower, upper] : bounds) {
+        configuration_t expected(initial.begin() + lower, initial.begin() + upper);
+        configuration_t actual(configuration.begin() + lower, configuration.begin() + upper);
+        std::ranges::sort(expected);
+        std::ranges::sort(actual);
+        ASSERT_EQ(expected, actual);
+        std::fill(inside.begin() + lower, inside.begin() + upper, true);
+      }
+      for (usize_t i = 0; i < configuration.size(); ++i)
+        if (!inside[i]) ASSERT_EQ(configuration[i], initial[i]);
+    }
+  }
+
+  TEST(Shuffle, interleaved_matches_sequential) {
+    std::vector<bounds_t<usize_t>> bounds{{0, 37}, {37, 38}, {40, 100}};
+    shuffler sequential(bounds, 7), interleaved(bounds, 7);
+    std::vector<configuration_t> expected(5, make_configuration(100));
+    std::vector<configuration_t> actual(expected);
+    for (auto iteration = 0; iteration < 3; ++iteration) {
+      for (auto& configuration : expected)
+        sequential.shuffle<ITERATION_MODE_RANDOM>(configuration);
+      interleaved.shuffle(actual);
+      ASSERT_EQ(expected, actual);
+      ASSERT_EQ(sequential.state(), interleaved.state());
+    }
+  }
+
+  TEST(Shuffle, keyed_depends_only_on_iteration) {
+    std::vector<bounds_t<usize_t>> bounds{{0, 60}, {60, 100}};
+    shuffler first(bounds, 42), second(bounds, 42);
+    auto initial = make_configuration(100);
+    std::vector<configuration_t> expected;
+    configuration_t configuration(initial.size());
+    for (iterations_t iteration = 0; iteration < 20; ++iteration) {
+      first.shuffle(configuration, initial, iteration);
+      expected.push_back(configuration);
+    }
+    ASSERT_NE(expected.front(), expected.back());
+    for (iterations_t iteration = 20; iteration-- > 0;) {
+      std::ranges::reverse(configuration);
+      second.shuffle(configuration, initial, iteration);
+      ASSERT_EQ(configuration, expected[iteration]);
+    }
+  }
+
+}  // namespace sqsgen::testing
@@ -10,6 +10,7 @@
 #include <nlohmann/json.hpp>
 
 #include "helpers.h"
+#include "sqsgen/core/geometry.h"
 #include "sqsgen/core/helpers.h"
 #include "sqsgen/core/structure.h"
 #include "sqsgen/io/json.h"
@@ -143,6 +144,25 @@ namespace sqsgen::testing {
            && core::helpers::is_close(lcoords(2), rcoords(2));
   }
 
+  TEST_F(StructureTestFixture, pairs) {
+    for (const auto& test_case : this->test_cases) {
+      auto structure = test_case.structure();
+      auto radii = distances_naive(std::forward<core::structure<double>>(structure));
+      shell_weights_t<double> weights;
+      for (usize_t shell = 1; shell < std::min<std::size_t>(radii.size(), 5); ++shell)
+        weights[shell] = 1.0;
+      // the pairs are found by a neighbor search and must match the dense shell matrix
+      auto pairs = std::get<0>(structure.pairs(radii, weights, false));
+      auto m = structure.shell_matrix(radii);
+      std::vector<std::tuple<usize_t, usize_t, usize_t>> expected, actual;
+      for (usize_t i = 0; i < structure.size(); ++i)
+        for (usize_t j = i + 1; j < structure.size(); ++j)
+          if (weights.contains(m(i, j))) expected.emplace_back(i, j, m(i, j));
+      for (auto&& [i, j, shell] : pairs) actual.emplace_back(i, j, shell);
+      ASSERT_EQ(expected, actual);
+    }
+  }
+
   TEST_F(SupercellTestFixture, supercell) {
     for (const auto& test_case : this->test_cases) {
       auto shape = test_case.shape;
@@ -158,6 +178,37 @@ namespace sqsgen::testing {
     }
   }
 
+  TEST_F(SupercellTestFixture, pairs) {
+    for (const auto& test_case : this->test_cases) {
+      auto shape = test_case.shape;
+      auto supercell = test_case.structure.supercell(std::get<0>(shape), std::get<1>(shape),
+                                                     std::get<2>(shape));
+      auto radii = distances_naive(core::structure<double>(supercell));
+      shell_weights_t<double> weights;
+      for (usize_t shell = 1; shell < std::min<std::size_t>(radii.size(), 4); ++shell)
+        weights[shell] = 1.0;
+      // the pairs obtained by translating the primitive cell must match the dense shell matrix
+      auto pairs = std::get<0>(supercell.pairs(radii, weights, false));
+      auto m = supercell.shell_matrix(radii);
+      std::vector<std::tuple<usize_t, usize_t, usize_t>> expected, actual;
+      for (usize_t i = 0; i < supercell.size(); ++i)
+        for (usize_t j = i + 1; j < supercell.size(); ++j)
+          if (weights.contains(m(i, j))) expected.emplace_back(i, j, m(i, j));
+      for (auto&& [i, j, shell] : pairs) actual.emplace_back(i, j, shell);
+      ASSERT_EQ(expected, actual);
+
+      // the implicit pair list must visit every pair exactly once
+      auto periodic = supercell.periodic_pairs(radii, weights, false);
+      ASSERT_TRUE(periodic.has_value());
+      std::vector<std::tuple<usize_t, usize_t, usize_t>> generated;
+      periodic.value().for_each([&](usize_t i, usize_t j, usize_t shell) {
+        generated.emplace_back(std::min(i, j), std::max(i, j), shell);
+      });
+      std::sort(generated.begin(), generated.end());
+      ASSERT_EQ(expected, generated);
+    }
+  }
+
   template <class T> const static auto TEST_FCC_STRUCTURE = core::structure<T>{
       lattice_t<T>{{1, 0, 0}, {0, 2, 0}, {0, 0, 3}},
       coords_t<T>{{0.0, 0.0, 0.0}, {0.0, 0.5, 0.5}, {0.5, 0.0, 0.5}, {0.5, 0.5, 0.0}},
@@ -237,4 +288,81 @@ namespace sqsgen::testing {
         {12, 6, 24, 12, 12, 8});
   }
 
+  TEST(Structure, prefactors_geometry) {
+    auto fcc = core::structure<double>{lattice_t<double>::Identity(),
+                                       coords_t<double>{{0.0, 0.0, 0.0},
+                                                        {0.0, 0.5, 0.5},
+                                                        {0.5, 0.0, 0.5},
+                                                        {0.5, 0.5, 0.0}},
+                                       configuration_t{1, 2, 2, 2}}
+                   .supercell(3, 3, 3);
+    // a slice has no supercell shape, hence its neighbors are counted on an explicit pair list
+    auto slice = fcc.sliced(core::helpers::range(fcc.size()));
+    shell_weights_t<double> w{{1, 1}, {2, 1}, {4, 1}};
+
+    core::geometry_cache<double> geometry;
+    for (auto* s : {&fcc, &slice}) {
+      auto radii = distances_naive(core::structure<double>{*s});
+      auto expected = compute_prefactors(core::structure<double>{*s}, radii, w);
+      auto prefactors = compute_prefactors(*s, radii, w, geometry);
+      helpers::assert_vector_is_close(
+          std::vector(prefactors.data(), prefactors.data() + prefactors.size()),
+          std::vector(expected.data(), expected.data() + expected.size()));
+    }
+    ASSERT_TRUE(geometry.periodic_pairs(fcc, distances_naive(core::structure<double>{fcc}), w));
+    // the neighbor analysis is not repeated for structures of the same geometry
+    auto size = geometry.size();
+    auto other = fcc.with_species(configuration_t(fcc.size(), 3));
+    compute_prefactors(other, distances_naive(core::structure<double>{fcc}), w, geometry);
+    ASSERT_EQ(geometry.size(), size);
+  }
+
+  TEST(Structure, geometry_directory) {
+    auto fcc = core::structure<double>{lattice_t<double>::Identity(),
+                                       coords_t<double>{{0.0, 0.0, 0.0},
+                                                        {0.0, 0.5, 0.5},
+                                                        {0.5, 0.0, 0.5},
+                                                        {0.5, 0.5, 0.0}},
+                                       configuration_t{1, 2, 2, 2}}
+                   .supercell(3, 3, 3);
+    auto slice = fcc.sliced(core::helpers::range(fcc.size()));
+    shell_weights_t<double> w{{1, 1}, {2, 1}, {4, 1}};
+    auto radii = distances_naive(core::structure<double>{fcc});
+    auto directory = std::filesystem::temp_directory_path() / "sqsgen-test-geometry";
+    std::filesystem::remove_all(directory);
+
+    core::geometry_cache<double> first(directory);
+    auto periodic = first.periodic_pairs(fcc, radii, w);
+    auto pairs = std::get<0>(first.pairs(slice, radii, w));
+    auto files = std::vector(std::filesystem::directory_iterator(directory),
+                             std::filesystem::directory_iterator{});
+    ASSERT_EQ(files.size(), 2);
+
+    // a new context reads the entries back instead of computing them
+    core::geometry_cache<double> second(directory);
+    auto loaded = second.periodic_pairs(fcc, radii, w);
+    ASSERT_TRUE(periodic.has_value() && loaded.has_value());
+    ASSERT_EQ(loaded.value().bounds, periodic.value().bounds);
+    ASSERT_EQ(loaded.value().templates.size(), periodic.value().templates.size());
+    for (auto i = 0u; i < loaded.value().templates.size(); ++i) {
+      ASSERT_EQ(loaded.value().templates[i].offset, periodic.value().templates[i].offset);
+      ASSERT_EQ(loaded.value().templates[i].shell, periodic.value().templates[i].shell);
+      ASSERT_EQ(loaded.value().templates[i].symmetric, periodic.value().templates[i].symmetric);
+    }
+    auto loaded_pairs = std::get<0>(second.pairs(slice, radii, w));
+    ASSERT_EQ(loaded_pairs.size(), pairs.size());
+    for (auto i = 0u; i < pairs.size(); ++i)
+      ASSERT_TRUE(loaded_pairs[i].i == pairs[i].i && loaded_pairs[i].j == pairs[i].j
+                  && loaded_pairs[i].shell == pairs[i].shell);
+
+    // a damaged file is recomputed and replaced
+    for (auto const& file : files)
+      std::ofstream(file.path(), std::ios::binary | std::ios::trunc) << "garbage";
+    core::geometry_cache<double> third(directory);
+    ASSERT_EQ(std::get<0>(third.pairs(slice, radii, w)).size(), pairs.size());
+    core::geometry_cache<double> fourth(directory);
+    ASSERT_EQ(std::get<0>(fourth.pairs(slice, radii, w)).size(), pairs.size());
+    std::filesystem::remove_all(directory);
+  }
+
 }  // namespace sqsgen::testing
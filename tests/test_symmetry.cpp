@@ -0,0 +1,64 @@
+//
+// Created by Dominik Gehringer on 19.10.26.
+//
+
+#include <gtest/gtest.h>
+
+#include "sqsgen/core/symmetry.h"
+
+namespace sqsgen::testing {
+  using namespace sqsgen::core;
+
+  structure<double> fcc_supercell(std::size_t n) {
+    lattice_t<double> lattice = lattice_t<double>::Identity() * 4.05;
+    coords_t<double> coords(4, 3);
+    coords << 0, 0, 0, 0, 0.5, 0.5, 0.5, 0, 0.5, 0.5, 0.5, 0;
+    return structure<double>(lattice, coords, {13, 13, 13, 13}).supercell(n, n, n);
+  }
+
+  void assert_bijections(std::vector<std::vector<usize_t>> const& permutations, usize_t size) {
+    for (auto&& permutation : permutations) {
+      auto sorted = permutation;
+      ranges::sort(sorted);
+      ASSERT_EQ(sorted, helpers::as<std::vector>{}(helpers::range(size)));
+    }
+  }
+
+  TEST(Symmetry, fcc_site_permutations) {
+    auto supercell = fcc_supercell(2);
+    std::vector<usize_t> labels(supercell.size(), 0);
+    auto translations = site_permutations(supercell, labels, true);
+    ASSERT_EQ(translations.size(), 32);
+    assert_bijections(translations, supercell.size());
+    auto symmetry = site_permutations(supercell, labels, false);
+    ASSERT_EQ(symmetry.size(), 48 * 32);
+    assert_bijections(symmetry, supercell.size());
+
+    // a site with a unique label must be a fixed point
+    labels[5] = 1;
+    for (auto&& permutation : site_permutations(supercell, labels, false))
+      ASSERT_EQ(permutation[5], 5);
+    ASSERT_EQ(site_permutations(supercell, labels, true).size(), 1);
+  }
+
+  TEST(Symmetry, canonicalize_translated_configurations) {
+    auto supercell = fcc_supercell(2);
+    auto translations
+        = site_permutations(supercell, std::vector<usize_t>(supercell.size(), 0), true);
+    std::vector<std::vector<std::vector<usize_t>>> group;
+    for (auto&& permutation : translations) group.push_back({permutation});
+    canonicalizer canonicalizer(group);
+
+    configuration_t configuration(supercell.size(), 0);
+    configuration[3] = configuration[17] = configuration[22] = 1;
+    auto expected{configuration};
+    canonicalizer.canonicalize(expected);
+    for (auto&& permutation : translations) {
+      configuration_t image(configuration.size());
+      for (usize_t i = 0; i < configuration.size(); ++i) image[permutation[i]] = configuration[i];
+      canonicalizer.canonicalize(image);
+      ASSERT_EQ(image, expected);
+    }
+  }
+
+}  // namespace sqsgen::testing